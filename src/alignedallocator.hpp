@@ -0,0 +1,50 @@
+#ifndef SRC_ALIGNEDALLOCATOR_HPP_
+#define SRC_ALIGNEDALLOCATOR_HPP_
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Allocator returning memory aligned for full-width vector loads and stores
+ * (32 bytes covers AVX). std::allocator only guarantees alignof(max_align_t).
+ */
+template<typename T, size_t Alignment = 32>
+class AlignedAllocator {
+public:
+  typedef T value_type;
+
+  template<typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() {
+  }
+
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) {
+  }
+
+  T* allocate(size_t n) {
+    void* p = nullptr;
+    if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, size_t) {
+    free(p);
+  }
+};
+
+template<typename T, typename U, size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) {
+  return true;
+}
+
+template<typename T, typename U, size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) {
+  return false;
+}
+
+#endif /* SRC_ALIGNEDALLOCATOR_HPP_ */
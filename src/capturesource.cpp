@@ -0,0 +1,75 @@
+#include "capturesource.hpp"
+#include <algorithm>
+#include <thread>
+#include "recordingtap.hpp"
+
+CaptureSource::~CaptureSource() {
+}
+
+StreamSource::StreamSource(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate, size_t hop, bool realtime) :
+    callback_(callback),
+    bufferSize_(bufferSize),
+    sampleRate_(sampleRate),
+    realtime_(realtime),
+    assembler_(bufferSize, hop),
+    //one read per hop, as a capture device would deliver it
+    block_(std::min<size_t>(assembler_.getHop(), 4096)),
+    finished_(false),
+    captured_(0),
+    frames_(0),
+    reads_(0) {
+}
+
+StreamSource::~StreamSource() {
+}
+
+RecorderStats StreamSource::getStats() const {
+  RecorderStats stats;
+  stats.captured = captured_.load(std::memory_order_relaxed);
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  stats.polls = reads_.load(std::memory_order_relaxed);
+  stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+  if (stats.elapsed > 0)
+    stats.pollRate = stats.polls / stats.elapsed;
+  return stats;
+}
+
+void StreamSource::stream() {
+  uint64_t position = 0;
+  while (true) {
+    size_t count = read(block_.data(), block_.size());
+    if (count == 0)
+      break;
+
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    if (tap_)
+      tap_->push(block_.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+      if (assembler_.push(block_[i])) {
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        callback_(assembler_.frame(), bufferSize_, assembler_.getPosition());
+      }
+    }
+    position += count;
+    captured_.store(position, std::memory_order_relaxed);
+
+    if (realtime_) {
+      //the time the block would have taken to record
+      std::this_thread::sleep_until(startTime_ + std::chrono::microseconds(position * 1000000 / sampleRate_));
+    }
+  }
+  finished_.store(true);
+}
+
+void StreamSource::capture(bool detach) {
+  startTime_ = std::chrono::steady_clock::now();
+  if (!detach) {
+    stream();
+    return;
+  }
+
+  std::thread streamThread([&]() {
+    stream();
+  });
+  streamThread.detach();
+}
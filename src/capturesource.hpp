@@ -0,0 +1,111 @@
+#ifndef SRC_CAPTURESOURCE_HPP_
+#define SRC_CAPTURESOURCE_HPP_
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "alignedallocator.hpp"
+#include "frameassembler.hpp"
+
+class RecordingTap;
+
+/*
+ * Receives frames of bufferSize samples, valid only during the call.
+ * position is the sample count on the capture clock at the end of the frame.
+ */
+typedef std::function<void(const Aquila::SampleType* frame, size_t size, uint64_t position)> RecorderCallback;
+
+/*
+ * Sample format of the captured audio. For OpenAL, Float32 needs the
+ * AL_EXT_float32 extension; without it Recorder falls back to Mono16.
+ */
+enum SampleFormat {
+  Mono8,
+  Mono16,
+  Float32
+};
+
+struct RecorderStats {
+  uint64_t captured = 0;
+  uint64_t frames = 0;
+  /* captured blocks that did not (fully) fit into the queue */
+  uint64_t overruns = 0;
+  /* times the analysis thread was starved of audio, see the getStats() of each source */
+  uint64_t underruns = 0;
+  /* samples lost to overruns or skipped by DropOldest */
+  uint64_t droppedSamples = 0;
+  /* device polls since capture started and their rate per second */
+  uint64_t polls = 0;
+  double pollRate = 0;
+  /* periods in which in-callback analysis exceeded its CPU budget */
+  uint64_t budgetOverruns = 0;
+  /* seconds since capture started */
+  double elapsed = 0;
+};
+
+/*
+ * A source of audio frames for the detection pipeline: live capture
+ * (Recorder, JackRecorder) or a stream (StreamSource and its subclasses).
+ */
+class CaptureSource {
+public:
+  virtual ~CaptureSource();
+  /* starts delivering frames to the callback; returns at the end of a finite stream unless detached */
+  virtual void capture(bool detach = true) = 0;
+  virtual uint32_t getSampleRate() const = 0;
+  virtual SampleFormat getFormat() const = 0;
+  virtual RecorderStats getStats() const = 0;
+  /* records everything captured from now on, the tap must outlive the capture */
+  virtual void setTap(RecordingTap* tap) = 0;
+  /* true once a finite source has delivered all its audio */
+  virtual bool isFinished() const {
+    return false;
+  }
+};
+
+/*
+ * Base for sources that produce samples on demand. Blocks of a hop are read
+ * on a single thread and framed synchronously, so a run over the same input
+ * is deterministic. In realtime mode the reads are paced to the sample rate,
+ * otherwise the stream is processed as fast as possible.
+ */
+class StreamSource : public CaptureSource {
+  RecorderCallback callback_;
+  size_t bufferSize_;
+  uint32_t sampleRate_;
+  bool realtime_;
+  FrameAssembler assembler_;
+  std::vector<Aquila::SampleType, AlignedAllocator<Aquila::SampleType>> block_;
+  RecordingTap* tap_ = nullptr;
+  std::chrono::steady_clock::time_point startTime_;
+  std::atomic<bool> finished_;
+  std::atomic<uint64_t> captured_;
+  std::atomic<uint64_t> frames_;
+  std::atomic<uint64_t> reads_;
+
+  void stream();
+protected:
+  /* fills up to count samples, returns how many were read (0 at the end) */
+  virtual size_t read(Aquila::SampleType* samples, size_t count) = 0;
+  void setSampleRate(uint32_t sampleRate) {
+    sampleRate_ = sampleRate;
+  }
+public:
+  StreamSource(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate, size_t hop, bool realtime);
+  virtual ~StreamSource();
+  virtual void capture(bool detach = true);
+  virtual uint32_t getSampleRate() const {
+    return sampleRate_;
+  }
+  virtual RecorderStats getStats() const;
+  virtual void setTap(RecordingTap* tap) {
+    tap_ = tap;
+  }
+  virtual bool isFinished() const {
+    return finished_.load();
+  }
+};
+
+#endif /* SRC_CAPTURESOURCE_HPP_ */
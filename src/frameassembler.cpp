@@ -0,0 +1,16 @@
+#include "frameassembler.hpp"
+#include <algorithm>
+
+FrameAssembler::FrameAssembler(size_t frameSize, size_t hop) :
+    frameSize_(frameSize),
+    hop_(hop == 0 ? frameSize : hop),
+    ring_(2 * frameSize, 0.0) {
+}
+
+void FrameAssembler::reset(uint64_t skipped) {
+  std::fill(ring_.begin(), ring_.end(), 0.0);
+  pos_ = 0;
+  filled_ = 0;
+  sinceFrame_ = 0;
+  position_ += skipped;
+}
@@ -0,0 +1,67 @@
+#ifndef SRC_FRAMEASSEMBLER_HPP_
+#define SRC_FRAMEASSEMBLER_HPP_
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aquila/global.h"
+
+/*
+ * Turns a stream of samples into overlapping analysis frames of frameSize
+ * samples, one every hop samples.
+ *
+ * The history is kept in a mirrored ring: every sample is stored twice,
+ * frameSize apart, so the last frameSize samples are always contiguous in
+ * memory and a frame is just a pointer into the ring. Nothing is shifted
+ * or copied when a frame is emitted.
+ */
+class FrameAssembler {
+  size_t frameSize_;
+  size_t hop_;
+  std::vector<Aquila::SampleType> ring_;
+  size_t pos_ = 0;
+  size_t filled_ = 0;
+  size_t sinceFrame_ = 0;
+  uint64_t position_ = 0;
+public:
+  FrameAssembler(size_t frameSize, size_t hop);
+
+  /* appends a sample, returns true when a new frame is ready */
+  bool push(Aquila::SampleType sample) {
+    ++position_;
+    ring_[pos_] = sample;
+    ring_[pos_ + frameSize_] = sample;
+    if (++pos_ == frameSize_)
+      pos_ = 0;
+    if (filled_ < frameSize_)
+      ++filled_;
+
+    if (++sinceFrame_ >= hop_ && filled_ == frameSize_) {
+      sinceFrame_ = 0;
+      return true;
+    }
+    return false;
+  }
+
+  /* the last frameSize samples, oldest first; valid until the next push */
+  const Aquila::SampleType* frame() const {
+    return ring_.data() + pos_;
+  }
+
+  /* drops the history after a gap in the stream, skipped samples still advance the position */
+  void reset(uint64_t skipped = 0);
+
+  /* number of samples pushed or skipped so far, i.e. the end of the current frame */
+  uint64_t getPosition() const {
+    return position_;
+  }
+
+  size_t getFrameSize() const {
+    return frameSize_;
+  }
+
+  size_t getHop() const {
+    return hop_;
+  }
+};
+
+#endif /* SRC_FRAMEASSEMBLER_HPP_ */
@@ -1,252 +1,252 @@
 #include "jackrecorder.hpp"
-#include <cstdio>
+#include <algorithm>
 #include <cstdlib>
-#include <string>
-#include <string.h>
-#include <unistd.h>
+#include <cstring>
+#include <iostream>
 #include <thread>
-#include <pthread.h>
-#include <sys/time.h>
-#include <ctime>
-#include <fstream>
-
-using std::cerr;
-using std::endl;
-
-unsigned int nports = 0;
-jack_port_t **ports = NULL;
-jack_default_audio_sample_t **in = NULL;
-jack_nframes_t nframes = 0;
-const size_t sample_size = sizeof(jack_default_audio_sample_t);
-
-/* Synchronization between process thread and disk thread. */
-#define DEFAULT_RB_SIZE 16384		/* ringbuffer size in frames */
-jack_ringbuffer_t *rb = NULL;
-pthread_mutex_t disk_thread_lock = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t  data_ready = PTHREAD_COND_INITIALIZER;
-long overruns = 0;
-jack_thread_info_t thread_info;
-jack_client_t *client;
-
-void* disk_thread (void *arg)
-{
-	jack_thread_info_t *info = (jack_thread_info_t *) arg;
-	static jack_nframes_t total_captured = 0;
-	jack_nframes_t samples_per_frame = info->channels;
-	size_t bytes_per_frame = samples_per_frame * sample_size;
-	char *framebuf = (char*)malloc (bytes_per_frame);
-
-	pthread_setcanceltype (PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
-	pthread_mutex_lock (&disk_thread_lock);
-
-	info->status = 0;
-	std::vector<double> buffer;
-	double min = std::numeric_limits<double>::max();
-	double max = std::numeric_limits<double>::min();
-	std::ofstream dump("dump.raw");
-
-	while (1) {
-
-		/* Write the data one frame at a time.  This is
-		 * inefficient, but makes things simpler. */
-		while (info->can_capture &&
-		       (jack_ringbuffer_read_space (rb) >= bytes_per_frame)) {
-
-			jack_ringbuffer_read (rb, framebuf, bytes_per_frame);
-			dump.write(framebuf, bytes_per_frame);
-			int32_t frame = 0;
-			for(size_t i = 0; i < bytes_per_frame; ++i) {
-				int32_t shifted = ((int32_t)framebuf[i]) << (i*8);
- 				frame = frame | shifted;
-			}
-
-			buffer.push_back((double)frame);
-
-//			std::cerr << min << '\t' << max << std::endl;
-//			std::cerr << ((double)frame / std::numeric_limits<int32_t>::max()) * 255.0 << std::endl;
-			if(buffer.size() >= 1024) {
-				thread_info.callback(buffer);
-				buffer.clear();
-
-				if (++total_captured >= info->duration) {
-					printf ("disk thread finished\n");
-					goto done;
-				}
-			}
-		}
-
-		/* wait until process() signals more data */
-		pthread_cond_wait (&data_ready, &disk_thread_lock);
-	}
-
- done:
-	pthread_mutex_unlock (&disk_thread_lock);
-	free (framebuf);
-	return 0;
+#include "recordingtap.hpp"
+#include "sampleconvert.hpp"
+
+const size_t SAMPLE_SIZE = sizeof(jack_default_audio_sample_t);
+//consecutive analysing periods over budget before in-callback analysis is given up
+const size_t MAX_BUDGET_MISSES = 3;
+
+JackRecorder::JackRecorder(RecorderCallback callback, size_t bufferSize, size_t hop,
+    const std::vector<std::string>& sources, size_t ringFrames, const std::string& name) :
+    client_(NULL),
+    port_(NULL),
+    ring_(NULL),
+    callback_(callback),
+    bufferSize_(bufferSize),
+    sources_(sources),
+    assembler_(bufferSize, hop),
+    converted_(4096),
+    running_(false),
+    captured_(0),
+    frames_(0),
+    overruns_(0),
+    underruns_(0),
+    droppedSamples_(0),
+    wakeups_(0),
+    inCallback_(false),
+    rtAssembler_(bufferSize, hop),
+    estimates_(256),
+    budgetOverruns_(0) {
+  if ((client_ = jack_client_open(name.c_str(), JackNullOption, NULL)) == NULL) {
+    std::cerr << "jack server not running?" << std::endl;
+    exit(1);
+  }
+
+  sem_init(&dataReady_, 0, 0);
+  ring_ = jack_ringbuffer_create(std::max<size_t>(ringFrames, 2 * jack_get_buffer_size(client_)) * SAMPLE_SIZE);
+  /* JACK locks our pages when running realtime, but newly allocated ones
+   * still have to be touched before process() uses them */
+  jack_ringbuffer_mlock(ring_);
+  memset(ring_->buf, 0, ring_->size);
+
+  if ((port_ = jack_port_register(client_, "input", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0)) == NULL) {
+    std::cerr << "cannot register input port!" << std::endl;
+    jack_client_close(client_);
+    exit(1);
+  }
+
+  jack_set_process_callback(client_, process, this);
+  jack_on_shutdown(client_, shutdown, this);
 }
 
-int process(jack_nframes_t nframes, void *arg)
-{
-	int chn;
-	size_t i;
-	jack_thread_info_t *info = (jack_thread_info_t *) arg;
-
-	/* Do nothing until we're ready to begin. */
-	if ((!info->can_process) || (!info->can_capture))
-		return 0;
-
-	for (chn = 0; chn < nports; chn++)
-		in[chn] = (jack_default_audio_sample_t*)jack_port_get_buffer (ports[chn], nframes);
-
-	/* Sndfile requires interleaved data.  It is simpler here to
-	 * just queue interleaved samples to a single ringbuffer. */
-	for (i = 0; i < nframes; i++) {
-		for (chn = 0; chn < nports; chn++) {
-			if (jack_ringbuffer_write (rb, (char *) (in[chn]+i),
-					      sample_size)
-			    < sample_size)
-				overruns++;
-		}
-	}
-
-	/* Tell the disk thread there is work to do.  If it is already
-	 * running, the lock will not be available.  We can't wait
-	 * here in the process() thread, but we don't need to signal
-	 * in that case, because the disk thread will read all the
-	 * data queued before waiting again. */
-	if (pthread_mutex_trylock (&disk_thread_lock) == 0) {
-	    pthread_cond_signal (&data_ready);
-	    pthread_mutex_unlock (&disk_thread_lock);
-	}
-
-	return 0;
+JackRecorder::~JackRecorder() {
+  jack_deactivate(client_);
+  jack_client_close(client_);
+  jack_ringbuffer_free(ring_);
+  sem_destroy(&dataReady_);
 }
 
-void
-JackRecorder::jack_shutdown (void *arg)
-{
-	fprintf (stderr, "JACK shutdown\n");
-	// exit (0);
-	abort();
+uint32_t JackRecorder::getSampleRate() const {
+  return jack_get_sample_rate(client_);
 }
 
-size_t JackRecorder::getSampleRate() {
-	return jack_get_sample_rate (thread_info.client);
+std::vector<std::string> JackRecorder::list() const {
+  std::vector<std::string> result;
+  const char** ports = jack_get_ports(client_, NULL, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput);
+  if (ports == NULL)
+    return result;
+
+  for (const char** p = ports; *p; ++p) {
+    result.push_back(*p);
+  }
+  jack_free(ports);
+  return result;
 }
-void
-JackRecorder::setup_disk_thread (jack_thread_info_t *info)
-{
-
-	jack_nframes_t samplerate = jack_get_sample_rate (info->client);
-	unsigned int channels = info->channels;
-
-
 
-	if (info->duration == 0) {
-		info->duration = JACK_MAX_FRAMES;
-	} else {
-		info->duration *= samplerate;
-	}
-
-	info->can_capture = 0;
-
-	pthread_create (&info->thread_id, NULL, disk_thread, info);
+/* underruns counts the wakeups that found the ringbuffer empty */
+RecorderStats JackRecorder::getStats() const {
+  RecorderStats stats;
+  stats.captured = captured_.load(std::memory_order_relaxed);
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  stats.overruns = overruns_.load(std::memory_order_relaxed);
+  stats.underruns = underruns_.load(std::memory_order_relaxed);
+  stats.droppedSamples = droppedSamples_.load(std::memory_order_relaxed);
+  stats.budgetOverruns = budgetOverruns_.load(std::memory_order_relaxed);
+  //the analysis thread wakes up once per period instead of polling
+  stats.polls = wakeups_.load(std::memory_order_relaxed);
+  stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+  if (stats.elapsed > 0)
+    stats.pollRate = stats.polls / stats.elapsed;
+  return stats;
 }
 
-void
-JackRecorder::run_disk_thread (jack_thread_info_t *info)
-{
-	info->can_capture = 1;
-	pthread_join (info->thread_id, NULL);
-	if (overruns > 0) {
-		fprintf (stderr,
-			 "jackrec failed with %ld overruns.\n", overruns);
-		fprintf (stderr, " try a bigger buffer than -B %"
-			 PRIu32 ".\n", info->rb_size);
-		info->status = EPIPE;
-	}
+void JackRecorder::enableInCallbackAnalysis(PitchDetector& detector, EstimateCallback onEstimate, double budget) {
+  rtDetector_ = &detector;
+  onEstimate_ = onEstimate;
+  budget_ = budget;
+  rtSampleRate_ = jack_get_sample_rate(client_);
+  if (tap_)
+    std::cerr << "The recording tap only records while analysis runs on the analysis thread" << std::endl;
+  inCallback_.store(true, std::memory_order_release);
 }
 
-void
-JackRecorder::setup_ports (int sources, char *source_names[], jack_thread_info_t *info)
-{
-	unsigned int i;
-	size_t in_size;
-
-	/* Allocate data structures that depend on the number of ports. */
-	nports = sources;
-	ports = (jack_port_t **) malloc (sizeof (jack_port_t *) * nports);
-	in_size =  nports * sizeof (jack_default_audio_sample_t *);
-	in = (jack_default_audio_sample_t **) malloc (in_size);
-	rb = jack_ringbuffer_create (nports * sample_size * info->rb_size);
-
-	/* When JACK is running realtime, jack_activate() will have
-	 * called mlockall() to lock our pages into memory.  But, we
-	 * still need to touch any newly allocated pages before
-	 * process() starts using them.  Otherwise, a page fault could
-	 * create a delay that would force JACK to shut us down. */
-	memset(in, 0, in_size);
-	memset(rb->buf, 0, rb->size);
-
-	for (i = 0; i < nports; i++) {
-		char name[64];
-
-		sprintf (name, "input%d", i+1);
-
-		if ((ports[i] = jack_port_register (info->client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0)) == 0) {
-			fprintf (stderr, "cannot register input port \"%s\"!\n", name);
-			jack_client_close (info->client);
-			exit (1);
-		}
-	}
-
-	for (i = 0; i < nports; i++) {
-		if (jack_connect (info->client, source_names[i], jack_port_name (ports[i]))) {
-			fprintf (stderr, "cannot connect input port %s to %s\n", jack_port_name (ports[i]), source_names[i]);
-			jack_client_close (info->client);
-			exit (1);
-		}
-	}
-
-	info->can_process = 1;		/* process() can start, now */
+void JackRecorder::processInCallback(const float* samples, jack_nframes_t nframes) {
+  //steady_clock is served from the vDSO, reading it does not enter the kernel
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  PitchEstimate estimate;
+  size_t analysed = 0;
+  for (jack_nframes_t i = 0; i < nframes; ++i) {
+    if (rtAssembler_.push(samples[i])) {
+      ++analysed;
+      frames_.fetch_add(1, std::memory_order_relaxed);
+      if (rtDetector_->process(rtAssembler_.frame(), estimate)) {
+        estimate.position = rtAssembler_.getPosition();
+        estimates_.write(&estimate, 1);
+      }
+    }
+  }
+
+  //with a hop longer than the period most periods only buffer samples; they say
+  //nothing about the cost of the analysis and must not clear earlier misses
+  if (analysed == 0)
+    return;
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (elapsed > budget_ * nframes / rtSampleRate_) {
+    budgetOverruns_.fetch_add(1, std::memory_order_relaxed);
+    if (++budgetMisses_ >= MAX_BUDGET_MISSES)
+      inCallback_.store(false, std::memory_order_release);
+  } else {
+    budgetMisses_ = 0;
+  }
 }
 
+/* runs on the JACK thread: no locks, no allocation, no system calls that may block */
+int JackRecorder::process(jack_nframes_t nframes, void* arg) {
+  JackRecorder* self = static_cast<JackRecorder*>(arg);
+  if (!self->running_.load(std::memory_order_acquire))
+    return 0;
+
+  const char* in = static_cast<const char*>(jack_port_get_buffer(self->port_, nframes));
+  if (self->inCallback_.load(std::memory_order_relaxed)) {
+    self->captured_.fetch_add(nframes, std::memory_order_relaxed);
+    self->processInCallback(reinterpret_cast<const float*>(in), nframes);
+    sem_post(&self->dataReady_);
+    return 0;
+  }
+
+  size_t bytes = nframes * SAMPLE_SIZE;
+  //only whole samples, so the reader always sees aligned floats
+  size_t space = jack_ringbuffer_write_space(self->ring_) / SAMPLE_SIZE * SAMPLE_SIZE;
+  if (space < bytes) {
+    self->overruns_.fetch_add(1, std::memory_order_relaxed);
+    self->droppedSamples_.fetch_add((bytes - space) / SAMPLE_SIZE, std::memory_order_relaxed);
+    bytes = space;
+  }
+  jack_ringbuffer_write(self->ring_, in, bytes);
+  self->captured_.fetch_add(nframes, std::memory_order_relaxed);
+
+  //sem_post never blocks and is safe to call from a real-time thread
+  sem_post(&self->dataReady_);
+  return 0;
+}
 
-JackRecorder::JackRecorder(const std::string& name) {
-	memset(&thread_info, 0, sizeof (thread_info));
-	thread_info.rb_size = DEFAULT_RB_SIZE;
-
-	if ((client = jack_client_open (name.c_str(), JackNullOption, NULL)) == 0) {
-		fprintf (stderr, "jack server not running?\n");
-		exit (1);
-	}
-
-	  thread_info.client = client;
-		thread_info.channels = 1;
-		thread_info.can_process = 0;
-
-		setup_disk_thread (&thread_info);
-
-		jack_set_process_callback (client, process, &thread_info);
-
-		if (jack_activate (client)) {
-			fprintf (stderr, "cannot activate client");
-		}
+void JackRecorder::shutdown(void* arg) {
+  std::cerr << "JACK shutdown" << std::endl;
+  abort();
 }
 
-void JackRecorder::setCallback(JackRecorderCallback& callback) {
-	thread_info.callback = callback;
+void JackRecorder::consume(const float* samples, size_t count) {
+  for (size_t offset = 0; offset < count; offset += converted_.size()) {
+    size_t chunk = std::min(converted_.size(), count - offset);
+    convertSamples(samples + offset, converted_.data(), chunk);
+    if (tap_)
+      tap_->push(converted_.data(), chunk);
+
+    for (size_t i = 0; i < chunk; ++i) {
+      if (assembler_.push(converted_[i])) {
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        callback_(assembler_.frame(), bufferSize_, assembler_.getPosition());
+      }
+    }
+  }
 }
 
-JackRecorder::~JackRecorder() {
-	jack_client_close (client);
-	jack_ringbuffer_free (rb);
+void JackRecorder::drainEstimates() {
+  PitchEstimate estimate;
+  while (estimates_.read(&estimate, 1) == 1) {
+    onEstimate_(estimate);
+  }
 }
 
+void JackRecorder::analyse() {
+  jack_ringbuffer_data_t vector[2];
+  while (true) {
+    while (sem_wait(&dataReady_) != 0) {
+      //interrupted by a signal
+    }
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+    if (rtDetector_)
+      drainEstimates();
+
+    jack_ringbuffer_get_read_vector(ring_, vector);
+    size_t total = 0;
+    for (size_t i = 0; i < 2; ++i) {
+      total += vector[i].len / SAMPLE_SIZE * SAMPLE_SIZE;
+    }
+    if (total > 0 && rtDetector_ && !reportedFallback_ && !inCallback_.load(std::memory_order_acquire)) {
+      //the JACK thread only writes to the ring after leaving in-callback analysis, so
+      //it is done with rtAssembler_: carry on from its position and partial frame
+      drainEstimates();
+      assembler_ = rtAssembler_;
+      std::cerr << "In-callback analysis exceeded its CPU budget, continuing on the analysis thread" << std::endl;
+      reportedFallback_ = true;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+      consume(reinterpret_cast<const float*>(vector[i].buf), vector[i].len / SAMPLE_SIZE);
+    }
+    if (total == 0 && !inCallback_.load(std::memory_order_relaxed))
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+    jack_ringbuffer_read_advance(ring_, total);
+  }
+}
 
 void JackRecorder::capture(bool detach) {
-	char* sources[] = {"system:capture_1"};
-	setup_ports (1, sources, &thread_info);
-	run_disk_thread (&thread_info);
+  startTime_ = std::chrono::steady_clock::now();
+  std::thread analysisThread([&]() {
+    analyse();
+  });
+
+  running_.store(true, std::memory_order_release);
+  if (jack_activate(client_)) {
+    std::cerr << "cannot activate client" << std::endl;
+    exit(1);
+  }
+
+  for (const std::string& source : sources_) {
+    if (jack_connect(client_, source.c_str(), jack_port_name(port_))) {
+      std::cerr << "cannot connect input port " << jack_port_name(port_) << " to " << source << std::endl;
+      exit(1);
+    }
+  }
+
+  if (detach)
+    analysisThread.detach();
+  else
+    analysisThread.join();
 }
-
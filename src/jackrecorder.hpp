@@ -1,48 +1,107 @@
-#ifndef SRC_RECORDER_HPP_
-#define SRC_RECORDER_HPP_
-#include <iostream>
-#include <cmath>
-#include <cassert>
+#ifndef SRC_JACKRECORDER_HPP_
+#define SRC_JACKRECORDER_HPP_
+#include <atomic>
+#include <chrono>
 #include <cstddef>
-#include <functional>
+#include <cstdint>
+#include <string>
 #include <vector>
-#include <getopt.h>
+#include <semaphore.h>
 #include <jack/jack.h>
 #include <jack/ringbuffer.h>
+#include "alignedallocator.hpp"
+#include "capturesource.hpp"
+#include "frameassembler.hpp"
+#include "pitchdetector.hpp"
+#include "spscring.hpp"
 
-typedef std::function<void(std::vector<double>&)> JackRecorderCallback;
+/*
+ * Captures from JACK. The process() callback runs on JACK's real-time
+ * thread and only copies the period into a jack ringbuffer and posts a
+ * semaphore (no locks, no allocation). An analysis thread consumes the
+ * native float samples in bulk through the ringbuffer's read vector,
+ * assembles frames and runs the callback.
+ *
+ * All source ports are connected to a single input port, so JACK mixes
+ * them down to mono.
+ *
+ * For the lowest latency the analysis can instead run inside process()
+ * (see enableInCallbackAnalysis): the port buffer is fed straight into a
+ * preallocated frame assembler and pitch detector, and the estimates are
+ * posted to a lock-free queue that the analysis thread drains. Nothing on
+ * that path allocates or locks. If the analysis takes more than the given
+ * share of the period in a few consecutive periods that complete a frame
+ * (periods that only buffer samples do not count), process() switches back
+ * to the ringbuffer and the threaded path for good. The threaded path takes
+ * over the in-callback assembler state before it reads the first samples
+ * from the ring, so frame positions keep increasing and the partial frame
+ * is not lost.
+ */
+typedef std::function<void(const PitchEstimate& estimate)> EstimateCallback;
 
-typedef struct _thread_info {
-    pthread_t thread_id;
-    jack_nframes_t duration;
-    jack_nframes_t rb_size;
-    jack_client_t *client;
-    unsigned int channels;
-    int bitdepth;
-    char *path;
-    volatile int can_capture;
-    volatile int can_process;
-    volatile int status;
-    JackRecorderCallback callback;
-} jack_thread_info_t;
+class JackRecorder : public CaptureSource {
+  jack_client_t* client_;
+  jack_port_t* port_;
+  jack_ringbuffer_t* ring_;
+  sem_t dataReady_;
+  RecorderCallback callback_;
+  size_t bufferSize_;
+  std::vector<std::string> sources_;
+  FrameAssembler assembler_;
+  std::vector<Aquila::SampleType, AlignedAllocator<Aquila::SampleType>> converted_;
+  RecordingTap* tap_ = nullptr;
+  std::chrono::steady_clock::time_point startTime_;
+  std::atomic<bool> running_;
+  std::atomic<uint64_t> captured_;
+  std::atomic<uint64_t> frames_;
+  std::atomic<uint64_t> overruns_;
+  std::atomic<uint64_t> underruns_;
+  std::atomic<uint64_t> droppedSamples_;
+  std::atomic<uint64_t> wakeups_;
 
-class JackRecorder {
-private:
-  JackRecorderCallback callback_;
-  void jack_shutdown(void *arg);
-  void setup_disk_thread (jack_thread_info_t *info);
-  void run_disk_thread (jack_thread_info_t *info);
-  void setup_ports (int sources, char *source_names[], jack_thread_info_t *info);
+  /* in-callback analysis, owned by the JACK thread while active */
+  std::atomic<bool> inCallback_;
+  PitchDetector* rtDetector_ = nullptr;
+  FrameAssembler rtAssembler_;
+  SpscRing<PitchEstimate> estimates_;
+  EstimateCallback onEstimate_;
+  double budget_ = 0.5;
+  double rtSampleRate_ = 0;
+  size_t budgetMisses_ = 0;
+  std::atomic<uint64_t> budgetOverruns_;
+  bool reportedFallback_ = false;
 
+  static int process(jack_nframes_t nframes, void* arg);
+  void processInCallback(const float* samples, jack_nframes_t nframes);
+  static void shutdown(void* arg);
+  void consume(const float* samples, size_t count);
+  void drainEstimates();
+  void analyse();
 public:
-	JackRecorder(const std::string& name);
+  JackRecorder(RecorderCallback callback, size_t bufferSize, size_t hop = 0,
+      const std::vector<std::string>& sources = std::vector<std::string>(1, "system:capture_1"),
+      size_t ringFrames = 16384, const std::string& name = "pitchDetect");
   virtual ~JackRecorder();
-  void setCallback(JackRecorderCallback& callback);
-  void capture(bool detach = true);
-  size_t getSampleRate();
-
-  std::vector<std::string> list();
-
+  virtual void capture(bool detach = true);
+  virtual uint32_t getSampleRate() const;
+  virtual SampleFormat getFormat() const {
+    return Float32;
+  }
+  virtual RecorderStats getStats() const;
+  /*
+   * Runs the detector on the JACK thread. Must be called before capture().
+   * budget is the share of a period the analysis may use before falling
+   * back to the threaded path, where the regular callback takes over.
+   */
+  void enableInCallbackAnalysis(PitchDetector& detector, EstimateCallback onEstimate, double budget = 0.5);
+  bool isInCallback() const {
+    return inCallback_.load(std::memory_order_relaxed);
+  }
+  virtual void setTap(RecordingTap* tap) {
+    tap_ = tap;
+  }
+  /* audio output ports that can be used as sources */
+  std::vector<std::string> list() const;
 };
 
-#endif /* SRC_RECORDER_HPP_ */
+#endif /* SRC_JACKRECORDER_HPP_ */
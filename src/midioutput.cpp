@@ -0,0 +1,92 @@
+#include "midioutput.hpp"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+const std::vector<std::string> NOTE_LUT = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+//notes at or below this are ignored
+const size_t MIN_NOTE = 40;
+
+MidiOutput::MidiOutput(RtMidiOut* midiout, uint32_t sampleRate, std::chrono::microseconds interval) :
+    midiout_(midiout),
+    sampleRate_(sampleRate),
+    interval_(interval),
+    queue_(1024),
+    batch_(queue_.capacity()),
+    message_(3),
+    running_(true),
+    droppedEvents_(0),
+    coalescedEvents_(0) {
+  log_.reserve(64 * batch_.size());
+  thread_ = std::thread([&]() {
+    run();
+  });
+}
+
+MidiOutput::~MidiOutput() {
+  running_ = false;
+  thread_.join();
+}
+
+void MidiOutput::post(const PitchEstimate& estimate) {
+  if (estimate.note <= MIN_NOTE || estimate.note == lastPosted_)
+    return;
+
+  PitchEvent event;
+  event.time = (double)estimate.position / sampleRate_;
+  event.note = estimate.note;
+  event.frequency = estimate.frequency;
+  event.magnitude = estimate.magnitude;
+  if (queue_.write(&event, 1) == 1)
+    lastPosted_ = estimate.note;
+  else
+    droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MidiOutput::send(uint8_t status, uint8_t note, uint8_t velocity) {
+  message_[0] = status;
+  message_[1] = note;
+  message_[2] = velocity;
+  midiout_->sendMessage(&message_);
+}
+
+void MidiOutput::flush(size_t count) {
+  log_.clear();
+  char line[128];
+  for (size_t i = 0; i < count; ++i) {
+    const PitchEvent& event = batch_[i];
+    const size_t p = event.note;
+    snprintf(line, sizeof(line), "%s%zu\t%zu\t%g\t%.3f\n", NOTE_LUT[p % 12].c_str(), (size_t)floor(p / 12.0), p,
+        event.magnitude, event.time);
+    log_ += line;
+  }
+
+  //only the last note of the batch is still sounding
+  const size_t p = batch_[count - 1].note;
+  if (p != lastNote_) {
+    if (lastNote_ > 0)
+      send(0x80, lastNote_ + 11, 0);
+    send(0x90, p + 11, 0x1F);
+    lastNote_ = p;
+  }
+  coalescedEvents_.fetch_add(count - 1, std::memory_order_relaxed);
+
+  std::cout.write(log_.data(), log_.size());
+  std::cout.flush();
+}
+
+void MidiOutput::run() {
+  while (true) {
+    bool stopping = !running_.load();
+    size_t count = queue_.read(batch_.data(), batch_.size());
+    if (count > 0)
+      flush(count);
+    else if (stopping)
+      break;
+    //events arriving meanwhile are handled as one batch
+    std::this_thread::sleep_for(interval_);
+  }
+
+  if (lastNote_ > 0)
+    send(0x80, lastNote_ + 11, 0);
+}
@@ -0,0 +1,68 @@
+#ifndef SRC_MIDIOUTPUT_HPP_
+#define SRC_MIDIOUTPUT_HPP_
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <RtMidi.h>
+#include "pitchdetector.hpp"
+#include "spscring.hpp"
+
+struct PitchEvent {
+  /* seconds on the capture clock */
+  double time = 0;
+  size_t note = 0;
+  double frequency = 0;
+  double magnitude = 0;
+};
+
+/*
+ * Sends note changes to MIDI and logs them to stdout on its own thread, so
+ * neither a slow terminal nor a busy MIDI driver can stall detection.
+ *
+ * post() is called by the analysis thread and only writes to a lock-free
+ * queue. The output thread wakes up every interval and handles everything
+ * queued since: the note-off/note-on pair is sent once, for the last note
+ * of the batch (changes that were already superseded are coalesced), and
+ * the log lines of the batch are written with a single flush.
+ */
+class MidiOutput {
+  RtMidiOut* midiout_;
+  uint32_t sampleRate_;
+  std::chrono::microseconds interval_;
+  SpscRing<PitchEvent> queue_;
+  std::vector<PitchEvent> batch_;
+  std::vector<uint8_t> message_;
+  std::string log_;
+  /* producer side: last note posted */
+  size_t lastPosted_ = 0;
+  /* output side: note currently sounding */
+  size_t lastNote_ = 0;
+  std::atomic<bool> running_;
+  std::atomic<uint64_t> droppedEvents_;
+  std::atomic<uint64_t> coalescedEvents_;
+  std::thread thread_;
+
+  void send(uint8_t status, uint8_t note, uint8_t velocity);
+  void flush(size_t count);
+  void run();
+public:
+  MidiOutput(RtMidiOut* midiout, uint32_t sampleRate,
+      std::chrono::microseconds interval = std::chrono::microseconds(2000));
+  virtual ~MidiOutput();
+  /* analysis thread: queues the estimate if it changes the note, never blocks */
+  void post(const PitchEstimate& estimate);
+
+  uint64_t getDroppedEvents() const {
+    return droppedEvents_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getCoalescedEvents() const {
+    return coalescedEvents_.load(std::memory_order_relaxed);
+  }
+};
+
+#endif /* SRC_MIDIOUTPUT_HPP_ */
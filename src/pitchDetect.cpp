@@ -15,13 +15,17 @@
 #include <chrono>
 #include <thread>
 #include <fstream>
+#include <csignal>
+#include <pthread.h>
 #include "aquila/global.h"
 #include "aquila/functions.h"
 #include "aquila/transform/FftFactory.h"
-#include "aquila/source/FramesCollection.h"
-#include "aquila/tools/TextPlot.h"
-#include "aquila/source/window/HammingWindow.h"
 #include "recorder.hpp"
+#include "recordingtap.hpp"
+#include "jackrecorder.hpp"
+#include "midioutput.hpp"
+#include "streamsources.hpp"
+#include "pitchdetector.hpp"
 
 namespace po = boost::program_options;
 
@@ -30,97 +34,47 @@ using std::cerr;
 using std::endl;
 using std::vector;
 RtMidiOut *midiout = new RtMidiOut();
-std::vector<uint8_t> message;
-size_t lastPitch = 0;
-
-const std::vector<string> NOTE_LUT = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
-typedef std::vector<double> AudioWindow;
-AudioWindow audio_buffer;
-
-
-void findDominantPitch(const vector<double>& source, size_t sampleRate) {
-  using namespace Aquila;
-  vector<double> target;
-  const std::size_t SIZE = source.size();
-	const double A1 = 440;
-	HammingWindow hamming(SIZE);
-  SignalSource in(source, sampleRate);
-  FramesCollection frames(in,SIZE);
-  auto signalFFT = FftFactory::getFft(SIZE);
-  TextPlot plot;
-  plot.setTitle("Signal");
-  //create a high pass filter to remove low frequency noise
-  const Aquila::FrequencyType f_hp = 200;
-  Aquila::SpectrumType filterSpectrum(SIZE);
-	for (std::size_t i = 0; i < SIZE; ++i) {
-		if (i < (SIZE * f_hp / sampleRate)) {
-			filterSpectrum[i] = 0.0;
-		} else {
-			filterSpectrum[i] = 1.0; //((double)SIZE - i) / SIZE;
-		}
-	}
-
-//	plot.plotSpectrum(filterSpectrum);
-
-  for (auto frame : frames) {
-  	frame *= hamming;
-
-		SpectrumType signalSpectrum = signalFFT->fft(frame.toArray());
-
-    std::transform(
-        std::begin(signalSpectrum),
-        std::end(signalSpectrum),
-        std::begin(filterSpectrum),
-        std::begin(signalSpectrum),
-        [] (Aquila::ComplexType x, Aquila::ComplexType y) { return x * y; }
-    );
-
-		for (std::size_t i = 0; i < SIZE; ++i) {
-			double maxMag = 0;
-			size_t maxJ = 0;
-			double totalMag = 0;
-
-			for (size_t j = 0; j < SIZE; ++j) {
-				auto& c = signalSpectrum[j];
-				const auto& mag = abs(c) / SIZE;
-				if (mag > maxMag) {
-					maxMag = mag;
-					maxJ = j;
-				}
-				totalMag += mag;
-			}
 
-      const double& freq = (maxJ * sampleRate) / (double)SIZE;
-
-    	size_t p = round(73.0 + 12.0 * log2(freq / A1));
-
-      if(p > 40 && freq < 22050 && maxMag > 0.12) {
-      	if(p != lastPitch) {
-					const size_t octave = floor(p / 12.0);
-					const string note = NOTE_LUT[p % 12];
-
-					message.clear();
-					message.push_back(0x80);
-					message.push_back(lastPitch + 11);
-					message.push_back(0);
-					midiout->sendMessage(&message);
-
-					//std::this_thread::sleep_for(std::chrono::milliseconds(200));
-					message.clear();
-					message.push_back(0x90);
-					message.push_back(p + 11);
-					message.push_back(0x1F);
-					midiout->sendMessage(&message);
-					//std::this_thread::sleep_for(std::chrono::milliseconds(200));
-
-					std::cout << note << octave << '\t' << p << '\t' << maxMag << std::endl << std::flush;
-					lastPitch = p;
-      	}
-      }
-    }
+void findDominantPitch(PitchDetector& detector, const Aquila::SampleType* frame, uint64_t position, MidiOutput& output) {
+  PitchEstimate estimate;
+  if (detector.process(frame, estimate)) {
+    estimate.position = position;
+    output.post(estimate);
   }
 }
 
+Aquila::PeakPicker::InterpolationType parseInterpolation(const string& name) {
+  if (name == "none")
+    return Aquila::PeakPicker::None;
+  else if (name == "parabolic")
+    return Aquila::PeakPicker::Parabolic;
+  else if (name == "gaussian")
+    return Aquila::PeakPicker::Gaussian;
+  else if (name == "complex")
+    return Aquila::PeakPicker::Complex;
+
+  std::cerr << "Unknown interpolation: " << name << std::endl;
+  exit(1);
+}
+
+Aquila::FftFactory::BackendType parseFftBackend(const string& name) {
+  if (name == "auto")
+    return Aquila::FftFactory::Automatic;
+  else if (name == "ooura")
+    return Aquila::FftFactory::Ooura;
+  else if (name == "fixed")
+    return Aquila::FftFactory::Fixed;
+  else if (name == "simd")
+    return Aquila::FftFactory::Simd;
+  else if (name == "portable")
+    return Aquila::FftFactory::Portable;
+  else if (name == "tuned")
+    return Aquila::FftFactory::Tuned;
+
+  std::cerr << "Unknown fft implementation: " << name << std::endl;
+  exit(1);
+}
+
 void normalize(std::vector<double>& data) {
   double min = std::numeric_limits<double>().max();
   double max = std::numeric_limits<double>().min();
@@ -139,39 +93,238 @@ void normalize(std::vector<double>& data) {
   }
 }
 
-void run(size_t bufferSize, uint32_t sampleRate) {
-  std::mutex bufferMutex;
-  RecorderCallback rc = [=](AudioWindow& buffer) {
-    findDominantPitch(buffer, sampleRate);
-  };
+DropPolicy parseDropPolicy(const string& name) {
+  if (name == "newest")
+    return DropNewest;
+  else if (name == "oldest")
+    return DropOldest;
 
-  Recorder recorder(rc, bufferSize, sampleRate);
-  recorder.capture(false);
+  std::cerr << "Unknown drop policy: " << name << std::endl;
+  exit(1);
 }
 
-int main(int argc, char** argv) {
-  string audioFile;
+WaitStrategy parseWaitStrategy(const string& name) {
+  if (name == "sleep")
+    return WaitSleep;
+  else if (name == "spin")
+    return WaitSpinThenSleep;
+  else if (name == "busy")
+    return WaitBusy;
+
+  std::cerr << "Unknown wait strategy: " << name << std::endl;
+  exit(1);
+}
+
+SampleFormat parseSampleFormat(const string& name) {
+  if (name == "8")
+    return Mono8;
+  else if (name == "16")
+    return Mono16;
+  else if (name == "float")
+    return Float32;
+
+  std::cerr << "Unknown sample format: " << name << std::endl;
+  exit(1);
+}
+
+void printStats(const RecorderStats& stats) {
+  std::cerr << "captured: " << stats.captured
+      << " frames: " << stats.frames
+      << " overruns: " << stats.overruns
+      << " underruns: " << stats.underruns
+      << " dropped: " << stats.droppedSamples
+      << " polls/s: " << stats.pollRate;
+  if (stats.budgetOverruns > 0)
+    std::cerr << " over budget: " << stats.budgetOverruns;
+  std::cerr << std::endl;
+}
+
+/* command line settings of a detection run */
+struct Settings {
+  string backend = "openal";
   size_t bufferSize = 1024;
+  size_t hop = 0;
   uint32_t sampleRate = 44100;
+  double minFrequency = 200;
+  double maxFrequency = 22050;
+  string method = "fft";
+  string interpolation = "gaussian";
+  string fft = "auto";
+  size_t queueFrames = 8;
+  string dropPolicy = "newest";
+  string waitStrategy = "sleep";
+  size_t spinMicros = 1000;
+  string format = "16";
+  std::vector<string> jackPorts = { "system:capture_1" };
+  size_t jackRing = 16384;
+  bool inCallback = false;
+  double budget = 0.5;
+  string input;
+  bool realtime = true;
+  double frequency = 440;
+  double amplitude = 0.5;
+  double duration = 10;
+  string recordFile;
+  double statsInterval = 0;
+};
+
+void capture(CaptureSource& source, double statsInterval) {
+  if (statsInterval <= 0) {
+    source.capture(false);
+    return;
+  }
+
+  source.capture(true);
+  while (!source.isFinished()) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(statsInterval));
+    printStats(source.getStats());
+  }
+}
+
+std::unique_ptr<CaptureSource> createSource(const Settings& settings, RecorderCallback rc) {
+  const string& backend = settings.backend;
+  if (backend == "openal") {
+    return std::unique_ptr<CaptureSource>(new Recorder(rc, settings.bufferSize, settings.sampleRate, settings.hop,
+        settings.queueFrames, parseDropPolicy(settings.dropPolicy), parseWaitStrategy(settings.waitStrategy),
+        std::chrono::microseconds(settings.spinMicros), parseSampleFormat(settings.format)));
+  } else if (backend == "jack") {
+    return std::unique_ptr<CaptureSource>(new JackRecorder(rc, settings.bufferSize, settings.hop, settings.jackPorts, settings.jackRing));
+  } else if (backend == "file") {
+    if (settings.input.empty()) {
+      std::cerr << "The file backend needs an input file" << std::endl;
+      exit(1);
+    }
+    return std::unique_ptr<CaptureSource>(new FileSource(rc, settings.input, settings.bufferSize, settings.hop,
+        settings.realtime, settings.sampleRate, parseSampleFormat(settings.format)));
+  } else if (backend == "pipe") {
+    return std::unique_ptr<CaptureSource>(new PipeSource(rc, settings.bufferSize, settings.hop,
+        settings.realtime, settings.sampleRate, parseSampleFormat(settings.format)));
+  } else if (backend == "sine" || backend == "pink") {
+    return std::unique_ptr<CaptureSource>(new GeneratorSource(rc, backend, settings.bufferSize, settings.hop,
+        settings.realtime, settings.sampleRate, settings.frequency, settings.amplitude, settings.duration));
+  }
+
+  std::cerr << "Unknown backend: " << backend << std::endl;
+  exit(1);
+}
+
+/* the recording tap the signal thread finishes before the process goes down */
+std::mutex tapMutex;
+RecordingTap* activeTap = nullptr;
+
+/*
+ * Live backends capture until the process is terminated, so SIGINT and
+ * SIGTERM are taken by a thread of their own which closes the recording
+ * and then lets the signal take its default course.
+ */
+void finishRecordingOnSignal() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  //blocked before any other thread exists, every thread inherits the mask
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  std::thread([signals]() {
+    int signal = 0;
+    while (sigwait(&signals, &signal) != 0) {
+    }
+    std::lock_guard<std::mutex> lock(tapMutex);
+    if (activeTap)
+      activeTap->close();
+    std::signal(signal, SIG_DFL);
+    pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
+    raise(signal);
+  }).detach();
+}
+
+void run(const Settings& settings) {
+  if (!settings.recordFile.empty())
+    finishRecordingOnSignal();
+
+  //with "tuned" the detectors below time the implementations for their sizes
+  Aquila::FftFactory::setBackend(parseFftBackend(settings.fft));
+  std::shared_ptr<PitchDetector> detector;
+  std::unique_ptr<MidiOutput> output;
+  RecorderCallback rc = [&](const Aquila::SampleType* frame, size_t size, uint64_t position) {
+    findDominantPitch(*detector, frame, position, *output);
+  };
+
+  std::unique_ptr<RecordingTap> tap;
+  std::unique_ptr<CaptureSource> source = createSource(settings, rc);
+  //the source decides the sample rate, e.g. JACK or a WAV file
+  const uint32_t sampleRate = source->getSampleRate();
+  detector = createPitchDetector(settings.method, settings.bufferSize, sampleRate,
+      settings.minFrequency, settings.maxFrequency, parseInterpolation(settings.interpolation));
+  output.reset(new MidiOutput(midiout, sampleRate));
+  if (!settings.recordFile.empty()) {
+    tap.reset(new RecordingTap(settings.recordFile, sampleRate, source->getFormat()));
+    source->setTap(tap.get());
+    std::lock_guard<std::mutex> lock(tapMutex);
+    activeTap = tap.get();
+  }
+
+  //a second detector, the one in the callback must not be shared with the analysis thread
+  std::shared_ptr<PitchDetector> rtDetector;
+  JackRecorder* jack = dynamic_cast<JackRecorder*>(source.get());
+  if (settings.inCallback && jack) {
+    rtDetector = createPitchDetector(settings.method, settings.bufferSize, sampleRate,
+        settings.minFrequency, settings.maxFrequency, parseInterpolation(settings.interpolation));
+    jack->enableInCallbackAnalysis(*rtDetector, [&](const PitchEstimate& estimate) {
+      output->post(estimate);
+    }, settings.budget);
+  }
+
+  capture(*source, settings.statsInterval);
+  if (settings.statsInterval > 0 || !settings.realtime)
+    printStats(source->getStats());
+  //stop recording before the source goes away
+  std::lock_guard<std::mutex> lock(tapMutex);
+  activeTap = nullptr;
+  tap.reset();
+}
+
+int main(int argc, char** argv) {
+  Settings settings;
   uint16_t midiPort = 0;
   uint16_t audioDevice = 0;
   po::options_description genericDesc("Options");
   genericDesc.add_options()("help,h", "Produce help message")
-		("buffersize,b", po::value<size_t>(&bufferSize)->default_value(bufferSize),"The internal audio buffer size")
-		("samplerate,s", po::value<uint32_t>(&sampleRate)->default_value(sampleRate),"The sample rate to record with")
+		("backend", po::value<string>(&settings.backend)->default_value(settings.backend),"Capture backend: openal, jack, file, pipe (raw PCM on stdin), sine or pink")
+		("input", po::value<string>(&settings.input),"Input file for the file backend (.wav, otherwise raw PCM in --format at --samplerate)")
+		("as-fast-as-possible", "Process file, pipe and generator sources without pacing them to the sample rate")
+		("frequency", po::value<double>(&settings.frequency)->default_value(settings.frequency),"Frequency of the sine backend")
+		("amplitude", po::value<double>(&settings.amplitude)->default_value(settings.amplitude),"Amplitude of the sine and pink backends")
+		("duration", po::value<double>(&settings.duration)->default_value(settings.duration),"Seconds the sine and pink backends run (0: forever)")
+		("buffersize,b", po::value<size_t>(&settings.bufferSize)->default_value(settings.bufferSize),"The internal audio buffer size")
+		("hop", po::value<size_t>(&settings.hop)->default_value(settings.hop),"Samples between the starts of two analysed frames (0: no overlap, hop = buffersize)")
+		("samplerate,s", po::value<uint32_t>(&settings.sampleRate)->default_value(settings.sampleRate),"The sample rate to record with")
 		("midiport,m", po::value<uint16_t>(&midiPort)->default_value(midiPort),"The midi port to send messages to")
 		("audiodev,a", po::value<uint16_t>(&audioDevice)->default_value(audioDevice),"The audio device to capture from")
+		("minfreq", po::value<double>(&settings.minFrequency)->default_value(settings.minFrequency),"The lowest frequency considered for pitch detection")
+		("maxfreq", po::value<double>(&settings.maxFrequency)->default_value(settings.maxFrequency),"The highest frequency considered for pitch detection")
+		("method", po::value<string>(&settings.method)->default_value(settings.method),"Pitch detection method: fft (spectral peak), yin or mpm (McLeod)")
+		("interpolation,i", po::value<string>(&settings.interpolation)->default_value(settings.interpolation),"Sub-bin peak interpolation: none, parabolic, gaussian or complex")
+		("fft", po::value<string>(&settings.fft)->default_value(settings.fft),"FFT implementation: auto, ooura, fixed, simd, portable or tuned (times each at startup and keeps the fastest)")
+		("queue", po::value<size_t>(&settings.queueFrames)->default_value(settings.queueFrames),"Capacity of the capture to analysis queue in buffers")
+		("drop", po::value<string>(&settings.dropPolicy)->default_value(settings.dropPolicy),"What to drop when analysis falls behind: newest (incoming audio) or oldest (the backlog)")
+		("format", po::value<string>(&settings.format)->default_value(settings.format),"Capture sample format: 8, 16 or float")
+		("wait", po::value<string>(&settings.waitStrategy)->default_value(settings.waitStrategy),"How the capture thread waits for audio: sleep, spin (spin-then-sleep) or busy")
+		("spin", po::value<size_t>(&settings.spinMicros)->default_value(settings.spinMicros),"Microseconds to spin before the next block is due with --wait spin")
+		("jackport", po::value<std::vector<string>>(&settings.jackPorts)->multitoken()->default_value(settings.jackPorts, "system:capture_1"),"JACK ports to capture from, mixed to mono")
+		("jackring", po::value<size_t>(&settings.jackRing)->default_value(settings.jackRing),"Size of the JACK ringbuffer in samples")
+		("incallback", po::bool_switch(&settings.inCallback),"Analyse inside the JACK process callback (jack backend only)")
+		("budget", po::value<double>(&settings.budget)->default_value(settings.budget),"Share of a JACK period in-callback analysis may use before falling back to the analysis thread")
+		("record,r", po::value<string>(&settings.recordFile),"Record the captured audio to a .wav or .flac file")
+		("stats", po::value<double>(&settings.statsInterval)->default_value(settings.statsInterval),"Print capture statistics every n seconds (0: never)")
 		("list,l", "List midi ports and audio devices");
 
 
-  po::options_description hidden("Hidden options");
-  hidden.add_options()("audioFile", po::value<string>(&audioFile), "audioFile");
-
   po::options_description cmdline_options;
-  cmdline_options.add(genericDesc).add(hidden);
+  cmdline_options.add(genericDesc);
 
   po::positional_options_description p;
-  p.add("audioFile", -1);
+  p.add("input", -1);
 
   po::options_description visible;
   visible.add(genericDesc);
@@ -179,6 +332,8 @@ int main(int argc, char** argv) {
   po::variables_map vm;
   po::store(po::command_line_parser(argc, argv).options(cmdline_options).positional(p).run(), vm);
   po::notify(vm);
+  if (vm.count("as-fast-as-possible"))
+    settings.realtime = false;
 
   if (vm.count("help")) {
     std::cerr << "Usage: pitchDetect [options]" << std::endl;
@@ -187,7 +342,11 @@ int main(int argc, char** argv) {
   }
   if(vm.count("list")) {
 		unsigned int nPorts = midiout->getPortCount();
-		const auto captureDevices = Recorder::list();
+		std::vector<string> captureDevices;
+		if (settings.backend == "jack")
+			captureDevices = JackRecorder(RecorderCallback(), settings.bufferSize).list();
+		else
+			captureDevices = Recorder::list();
 		if (nPorts == 0) {
 			std::cerr << "No ports available!\n";
 			exit(1);
@@ -213,7 +372,7 @@ int main(int argc, char** argv) {
   }
 	midiout->openPort(midiPort);
 	assert(midiout->isPortOpen());
-  run(bufferSize, sampleRate);
+  run(settings);
 
   return 0;
 }
@@ -0,0 +1,81 @@
+#include "pitchdetector.hpp"
+#include <cmath>
+#include <iostream>
+#include "aquila/transform/FftFactory.h"
+#include "aquila/source/window/WindowCache.h"
+#include "timedomaindetector.hpp"
+
+const double A1 = 440;
+//samples are normalized to [-1, 1), this used to be 0.12 for raw 8 bit values
+const double MIN_MAGNITUDE = 0.12 / 128;
+
+static size_t frequencyToBin(double frequency, size_t bufferSize, uint32_t sampleRate) {
+  return (size_t)ceil(frequency * bufferSize / sampleRate);
+}
+
+PitchDetector::PitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency, double maxFrequency) :
+    bufferSize_(bufferSize),
+    sampleRate_(sampleRate),
+    minFrequency_(minFrequency),
+    maxFrequency_(maxFrequency) {
+}
+
+PitchDetector::~PitchDetector() {
+}
+
+bool PitchDetector::setFrequency(double frequency, PitchEstimate& estimate) const {
+  estimate.frequency = frequency;
+  if (frequency <= 0 || frequency < minFrequency_ || frequency >= maxFrequency_)
+    return false;
+
+  estimate.note = round(73.0 + 12.0 * log2(frequency / A1));
+  return true;
+}
+
+FftPitchDetector::FftPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency, double maxFrequency,
+    Aquila::PeakPicker::InterpolationType interpolation) :
+    PitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency),
+    fft_(Aquila::FftFactory::getFft(bufferSize)),
+    window_(Aquila::WindowCache::get(Aquila::WindowCache::Hamming, bufferSize)),
+    spectrum_(bufferSize / 2 + 1),
+    //band pass: removes low frequency noise and everything above maxFrequency
+    picker_(bufferSize / 2 + 1,
+        frequencyToBin(minFrequency, bufferSize, sampleRate),
+        frequencyToBin(maxFrequency, bufferSize, sampleRate),
+        1, interpolation) {
+}
+
+FftPitchDetector::~FftPitchDetector() {
+}
+
+bool FftPitchDetector::process(const Aquila::SampleType* samples, PitchEstimate& estimate) {
+  //the input is real, so only the bins up to nyquist are unique;
+  //the window is applied while the fft stages its input
+  fft_->rfftWindowed(samples, window_->data(), spectrum_.data());
+
+  if (picker_.pick(spectrum_.data()) == 0)
+    return false;
+
+  const Aquila::SpectralPeak& peak = picker_.getPeak(0);
+  estimate.magnitude = sqrt(peak.power) / bufferSize_;
+  estimate.totalPower = picker_.getTotalPower() / ((double)bufferSize_ * bufferSize_);
+  estimate.confidence = peak.power / picker_.getTotalPower();
+  if (estimate.magnitude <= MIN_MAGNITUDE)
+    return false;
+
+  //sub-bin interpolation lets small frames resolve semitones in the bass range
+  return setFrequency((peak.position * sampleRate_) / (double)bufferSize_, estimate);
+}
+
+std::shared_ptr<PitchDetector> createPitchDetector(const std::string& method, size_t bufferSize, uint32_t sampleRate,
+    double minFrequency, double maxFrequency, Aquila::PeakPicker::InterpolationType interpolation) {
+  if (method == "fft")
+    return std::shared_ptr<PitchDetector>(new FftPitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency, interpolation));
+  else if (method == "yin")
+    return std::shared_ptr<PitchDetector>(new YinPitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency));
+  else if (method == "mpm")
+    return std::shared_ptr<PitchDetector>(new McLeodPitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency));
+
+  std::cerr << "Unknown pitch detection method: " << method << std::endl;
+  exit(1);
+}
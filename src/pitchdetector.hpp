@@ -0,0 +1,68 @@
+#ifndef SRC_PITCHDETECTOR_HPP_
+#define SRC_PITCHDETECTOR_HPP_
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "aquila/global.h"
+#include "aquila/transform/Fft.h"
+#include "aquila/transform/PeakPicker.h"
+
+struct PitchEstimate {
+  size_t note = 0;
+  double frequency = 0;
+  double magnitude = 0;
+  double totalPower = 0;
+  double confidence = 0;
+  /* end of the analysed frame on the capture clock, in samples (set by the caller) */
+  uint64_t position = 0;
+};
+
+/*
+ * A stateful pitch detector configured once for a fixed buffer size and
+ * sample rate. Implementations create their FFT plans, tables and all
+ * scratch buffers in the constructor and reuse them in every call to
+ * process(), which therefore does no setup work of its own and never
+ * touches the heap.
+ */
+class PitchDetector {
+protected:
+  size_t bufferSize_;
+  uint32_t sampleRate_;
+  double minFrequency_;
+  double maxFrequency_;
+  bool setFrequency(double frequency, PitchEstimate& estimate) const;
+public:
+  PitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency, double maxFrequency);
+  virtual ~PitchDetector();
+  virtual bool process(const Aquila::SampleType* samples, PitchEstimate& estimate) = 0;
+
+  size_t getBufferSize() const {
+    return bufferSize_;
+  }
+
+  uint32_t getSampleRate() const {
+    return sampleRate_;
+  }
+};
+
+/*
+ * Picks the largest bin of the windowed spectrum.
+ */
+class FftPitchDetector : public PitchDetector {
+  std::shared_ptr<Aquila::Fft> fft_;
+  std::shared_ptr<const std::vector<Aquila::SampleType> > window_;
+  Aquila::SpectrumType spectrum_;
+  Aquila::PeakPicker picker_;
+public:
+  FftPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency = 200, double maxFrequency = 22050,
+      Aquila::PeakPicker::InterpolationType interpolation = Aquila::PeakPicker::Gaussian);
+  virtual ~FftPitchDetector();
+  virtual bool process(const Aquila::SampleType* samples, PitchEstimate& estimate);
+};
+
+std::shared_ptr<PitchDetector> createPitchDetector(const std::string& method, size_t bufferSize, uint32_t sampleRate,
+    double minFrequency, double maxFrequency, Aquila::PeakPicker::InterpolationType interpolation);
+
+#endif /* SRC_PITCHDETECTOR_HPP_ */
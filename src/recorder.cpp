@@ -4,29 +4,49 @@
 #include <string.h>
 #include <unistd.h>
 #include <thread>
+#include <chrono>
+#include <algorithm>
 #include <sys/time.h>
 #include <ctime>
-#include <sndfile.hh>
-#include <fstream>
-
-std::ofstream dump("dump.wav");
+#include "recordingtap.hpp"
+#include "sampleconvert.hpp"
 
 using std::cerr;
 using std::endl;
 
-Recorder::Recorder(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate) :
+Recorder::Recorder(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate, size_t hop,
+    size_t queueFrames, DropPolicy dropPolicy, WaitStrategy waitStrategy, std::chrono::microseconds spin,
+    SampleFormat format) :
     callback_(callback),
 		bufferSize_(bufferSize),
-    sampleRate_(sampleRate) {
+    sampleRate_(sampleRate),
+    captureBuffer(1048576),
+    //wake up once per hop, but keep well inside the device buffer
+    captureBlock_(std::min<size_t>(hop == 0 ? bufferSize : hop, 2048)),
+    waitStrategy_(waitStrategy),
+    spin_(spin),
+    converted_(4096),
+    queue_(std::max<size_t>(queueFrames, 2) * bufferSize),
+    dropPolicy_(dropPolicy),
+    assembler_(bufferSize, hop),
+    block_(4096),
+    captured_(0),
+    frames_(0),
+    overruns_(0),
+    underruns_(0),
+    droppedSamples_(0),
+    polls_(0) {
   const ALCchar * devices;
 
   std::cerr << alcGetString(NULL, ALC_DEFAULT_DEVICE_SPECIFIER) << std::endl;
 
   std::cerr << "Opening capture device:" << std::endl;
-  captureDev_ = alcCaptureOpenDevice(NULL, sampleRate, AL_FORMAT_MONO8, 4096);
-  if (captureDev_ == NULL) {
-    std::cerr << "Unable to open device!:" << std::endl;
-    exit(1);
+  if (!open(format)) {
+    if (format != Float32 || !open(Mono16)) {
+      std::cerr << "Unable to open device!:" << std::endl;
+      exit(1);
+    }
+    std::cerr << "Float capture is not supported, using 16 bit" << std::endl;
   }
   devices = alcGetString(captureDev_, ALC_CAPTURE_DEVICE_SPECIFIER);
   std::cerr << "opened device" << devices << std::endl;
@@ -38,6 +58,24 @@ Recorder::~Recorder() {
 }
 
 
+bool Recorder::open(SampleFormat format) {
+  ALenum alFormat = AL_FORMAT_MONO8;
+  bytesPerSample_ = 1;
+  if (format == Mono16) {
+    alFormat = AL_FORMAT_MONO16;
+    bytesPerSample_ = 2;
+  } else if (format == Float32) {
+    alFormat = alGetEnumValue("AL_FORMAT_MONO_FLOAT32");
+    bytesPerSample_ = 4;
+    if (alFormat == 0 || alFormat == -1)
+      return false;
+  }
+
+  format_ = format;
+  captureDev_ = alcCaptureOpenDevice(NULL, sampleRate_, alFormat, 4096);
+  return captureDev_ != NULL;
+}
+
 std::vector<std::string> Recorder::list() {
   std::vector<std::string> result;
   const ALCchar * devices;
@@ -53,36 +91,135 @@ std::vector<std::string> Recorder::list() {
   return result;
 }
 
+/* underruns counts the gaps in which the next capture block was overdue by more than a capture period */
+RecorderStats Recorder::getStats() const {
+  RecorderStats stats;
+  stats.captured = captured_.load(std::memory_order_relaxed);
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  stats.overruns = overruns_.load(std::memory_order_relaxed);
+  stats.underruns = underruns_.load(std::memory_order_relaxed);
+  stats.droppedSamples = droppedSamples_.load(std::memory_order_relaxed);
+  stats.polls = polls_.load(std::memory_order_relaxed);
+  stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+  if (stats.elapsed > 0)
+    stats.pollRate = stats.polls / stats.elapsed;
+  return stats;
+}
+
+void Recorder::wait(size_t missing) {
+  //time until the device has captured the missing samples
+  const std::chrono::microseconds expected(1000000ULL * missing / sampleRate_);
+  switch (waitStrategy_) {
+  case WaitSleep:
+    std::this_thread::sleep_for(expected);
+    break;
+  case WaitSpinThenSleep:
+    if (expected > spin_)
+      std::this_thread::sleep_for(expected - spin_);
+    else
+      std::this_thread::yield();
+    break;
+  case WaitBusy:
+    break;
+  }
+}
+
+void Recorder::convert(const ALubyte* samples, Aquila::SampleType* out, size_t count) const {
+  switch (format_) {
+  case Mono8:
+    convertSamples(reinterpret_cast<const uint8_t*>(samples), out, count);
+    break;
+  case Mono16:
+    convertSamples(reinterpret_cast<const int16_t*>(samples), out, count);
+    break;
+  case Float32:
+    convertSamples(reinterpret_cast<const float*>(samples), out, count);
+    break;
+  }
+}
+
+void Recorder::enqueue(const ALubyte* samples, size_t count) {
+  captured_.fetch_add(count, std::memory_order_relaxed);
+  for (size_t offset = 0; offset < count; offset += converted_.size()) {
+    size_t chunk = std::min(converted_.size(), count - offset);
+    convert(samples + offset * bytesPerSample_, converted_.data(), chunk);
+    if (tap_)
+      tap_->push(converted_.data(), chunk);
+
+    size_t written = queue_.write(converted_.data(), chunk);
+    if (written < chunk) {
+      //never wait for the consumer: the rest of the block is lost
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      droppedSamples_.fetch_add(count - offset - written, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+void Recorder::analyse() {
+  //poll a few times per hop while the queue is empty
+  const std::chrono::microseconds idle(std::max<uint64_t>(500, 250000ULL * assembler_.getHop() / sampleRate_));
+  //a block is due every capture period; one still missing a period later is an underrun
+  const std::chrono::microseconds overdue(2000000ULL * captureBlock_ / sampleRate_);
+  std::chrono::steady_clock::time_point lastData;
+  bool started = false;
+  bool starved = false;
+  while (true) {
+    size_t available = queue_.readAvailable();
+    if (available == 0) {
+      if (started && !starved && std::chrono::steady_clock::now() - lastData > overdue) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        starved = true;
+      }
+      std::this_thread::sleep_for(idle);
+      continue;
+    }
+    lastData = std::chrono::steady_clock::now();
+    started = true;
+    starved = false;
+
+    if (dropPolicy_ == DropOldest && available > queue_.capacity() / 2) {
+      //keep only the newest frame worth of samples and restart framing there
+      size_t skipped = queue_.skip(available - bufferSize_);
+      droppedSamples_.fetch_add(skipped, std::memory_order_relaxed);
+      assembler_.reset(skipped);
+    }
+
+    size_t count = queue_.read(block_.data(), block_.size());
+    for (size_t i = 0; i < count; ++i) {
+      if (assembler_.push(block_[i])) {
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        callback_(assembler_.frame(), bufferSize_, assembler_.getPosition());
+      }
+    }
+  }
+}
+
 void Recorder::capture(bool detach) {
+  startTime_ = std::chrono::steady_clock::now();
+  std::thread analysisThread([&](){
+    analyse();
+  });
   std::thread captureThread([&](){
   alcCaptureStart(captureDev_);
   while (true) {
     alcGetIntegerv(captureDev_, ALC_CAPTURE_SAMPLES, sizeof(ALint), &samplesAvailable);
-    if (samplesAvailable > 1) {
-
-    	alcCaptureSamples(captureDev_, captureBuffer, samplesAvailable);
-
-      for(size_t i = 0; i < (size_t)samplesAvailable; i++) {
-        if(buffer.size() >= bufferSize_) {
-          callback_(buffer);
-          buffer.clear();
-        }
-//
-//        uint16_t sample = captureBuffer[i + 1];
-//        sample = sample | (((uint32_t)captureBuffer[i]) << 8);
-        dump << captureBuffer[i];
-//        buffer.push_back((double)sample / std::numeric_limits<uint16_t>::max());
-        buffer.push_back((double)captureBuffer[i]);
-
-      }
+    polls_.fetch_add(1, std::memory_order_relaxed);
+    if ((size_t)samplesAvailable >= captureBlock_) {
+      samplesAvailable = std::min<size_t>(samplesAvailable, captureBuffer.size() / bytesPerSample_);
+    	alcCaptureSamples(captureDev_, captureBuffer.data(), samplesAvailable);
+      enqueue(captureBuffer.data(), samplesAvailable);
+    } else {
+      wait(captureBlock_ - samplesAvailable);
     }
-
- //   usleep(10000);
   }
   });
-  if(detach)
+  if(detach) {
   	captureThread.detach();
-  else
+  	analysisThread.detach();
+  } else {
   	captureThread.join();
+  	analysisThread.join();
+  }
 }
 
@@ -4,24 +4,96 @@
 #include <cmath>
 #include <cassert>
 #include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include <AL/al.h>
 #include <AL/alc.h>
+#include "alignedallocator.hpp"
+#include "capturesource.hpp"
+#include "frameassembler.hpp"
+#include "spscring.hpp"
 
-typedef std::function<void(std::vector<double>&)> RecorderCallback;
-class Recorder {
+/*
+ * What happens to audio the analysis thread cannot keep up with.
+ * DropNewest: the capture thread discards blocks that do not fit the queue.
+ * DropOldest: additionally, the analysis thread skips a backlog of more than
+ * half the queue and restarts framing from the most recent samples, which
+ * bounds the latency.
+ */
+enum DropPolicy {
+  DropNewest,
+  DropOldest
+};
+
+/*
+ * How the capture thread waits for the device to fill the next hop.
+ * WaitSleep: sleeps for the time the missing samples take to arrive.
+ * WaitSpinThenSleep: sleeps until shortly before that and yields in a loop
+ * for the last spin interval, which trades CPU time for wakeup latency.
+ * WaitBusy: polls continuously.
+ */
+enum WaitStrategy {
+  WaitSleep,
+  WaitSpinThenSleep,
+  WaitBusy
+};
+
+/*
+ * Captures audio on one thread and analyses it on another. The two are
+ * decoupled by a lock-free single producer single consumer sample queue,
+ * so a slow callback never delays draining the capture device.
+ */
+class Recorder : public CaptureSource {
   ALCdevice * captureDev_;
   RecorderCallback callback_;
   size_t bufferSize_;
   uint32_t sampleRate_;
-  ALubyte captureBuffer[1048576];
+  SampleFormat format_;
+  size_t bytesPerSample_;
+  std::vector<ALubyte, AlignedAllocator<ALubyte>> captureBuffer;
   ALint samplesAvailable = 0;
-  std::vector<double> buffer;
+  size_t captureBlock_;
+  WaitStrategy waitStrategy_;
+  std::chrono::microseconds spin_;
+  std::chrono::steady_clock::time_point startTime_;
+  std::vector<Aquila::SampleType, AlignedAllocator<Aquila::SampleType>> converted_;
+  RecordingTap* tap_ = nullptr;
+  SpscRing<Aquila::SampleType> queue_;
+  DropPolicy dropPolicy_;
+  FrameAssembler assembler_;
+  std::vector<Aquila::SampleType, AlignedAllocator<Aquila::SampleType>> block_;
+  std::atomic<uint64_t> captured_;
+  std::atomic<uint64_t> frames_;
+  std::atomic<uint64_t> overruns_;
+  std::atomic<uint64_t> underruns_;
+  std::atomic<uint64_t> droppedSamples_;
+  std::atomic<uint64_t> polls_;
+
+  void wait(size_t missing);
+  bool open(SampleFormat format);
+  void convert(const ALubyte* samples, Aquila::SampleType* out, size_t count) const;
+  void enqueue(const ALubyte* samples, size_t count);
+  void analyse();
 public:
-  Recorder(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate);
+  Recorder(RecorderCallback callback, size_t bufferSize, uint32_t sampleRate, size_t hop = 0,
+      size_t queueFrames = 8, DropPolicy dropPolicy = DropNewest,
+      WaitStrategy waitStrategy = WaitSleep, std::chrono::microseconds spin = std::chrono::microseconds(1000),
+      SampleFormat format = Mono16);
   virtual ~Recorder();
-  void capture(bool detach = true);
+  virtual void capture(bool detach = true);
+  virtual RecorderStats getStats() const;
+  virtual void setTap(RecordingTap* tap) {
+    tap_ = tap;
+  }
+  virtual uint32_t getSampleRate() const {
+    return sampleRate_;
+  }
+  virtual SampleFormat getFormat() const {
+    return format_;
+  }
   static std::vector<std::string> list();
 };
 
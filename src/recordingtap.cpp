@@ -0,0 +1,80 @@
+#include "recordingtap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/* keeps the resolution of the capture format; FLAC has no float samples */
+static int fileFormat(const std::string& path, SampleFormat format) {
+  bool flac = endsWith(path, ".flac");
+  int container = flac ? SF_FORMAT_FLAC : SF_FORMAT_WAV;
+  switch (format) {
+  case Mono8:
+    return container | (flac ? SF_FORMAT_PCM_S8 : SF_FORMAT_PCM_U8);
+  case Float32:
+    return container | (flac ? SF_FORMAT_PCM_24 : SF_FORMAT_FLOAT);
+  default:
+    return container | SF_FORMAT_PCM_16;
+  }
+}
+
+RecordingTap::RecordingTap(const std::string& path, uint32_t sampleRate, SampleFormat format, double queueSeconds) :
+    file_(path.c_str(), SFM_WRITE, fileFormat(path, format), 1, sampleRate),
+    queue_(queueSeconds * sampleRate),
+    staging_(4096),
+    block_(16384),
+    running_(true),
+    droppedSamples_(0) {
+  if (file_.error()) {
+    std::cerr << "Unable to open recording file " << path << ": " << file_.strError() << std::endl;
+    exit(1);
+  }
+  if (!endsWith(path, ".flac"))
+    file_.command(SFC_SET_UPDATE_HEADER_AUTO, nullptr, SF_TRUE);
+  writer_ = std::thread([&]() {
+    write();
+  });
+}
+
+RecordingTap::~RecordingTap() {
+  close();
+}
+
+void RecordingTap::close() {
+  running_ = false;
+  if (writer_.joinable())
+    writer_.join();
+  file_ = SndfileHandle();
+}
+
+void RecordingTap::push(const Aquila::SampleType* samples, size_t count) {
+  for (size_t offset = 0; offset < count; offset += staging_.size()) {
+    size_t chunk = std::min(staging_.size(), count - offset);
+    std::copy(samples + offset, samples + offset + chunk, staging_.begin());
+    size_t written = queue_.write(staging_.data(), chunk);
+    if (written < chunk) {
+      droppedSamples_.fetch_add(count - offset - written, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+void RecordingTap::write() {
+  //the queue holds seconds of audio, polling a few times per second is plenty
+  const std::chrono::milliseconds idle(50);
+  while (true) {
+    bool stopping = !running_.load();
+    size_t count = queue_.read(block_.data(), block_.size());
+    if (count > 0) {
+      file_.writef(block_.data(), count);
+    } else if (stopping) {
+      break;
+    } else {
+      std::this_thread::sleep_for(idle);
+    }
+  }
+  file_.writeSync();
+}
@@ -0,0 +1,45 @@
+#ifndef SRC_RECORDINGTAP_HPP_
+#define SRC_RECORDINGTAP_HPP_
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sndfile.hh>
+#include "capturesource.hpp"
+#include "spscring.hpp"
+
+/*
+ * Records the captured audio to a WAV or FLAC file (chosen by the file
+ * extension) without doing any disk I/O on the capture thread: push()
+ * only copies the block into a lock-free queue, and a background thread
+ * writes it out through libsndfile. If the writer falls behind by more
+ * than the queue holds, push() drops audio instead of waiting.
+ *
+ * WAV headers are rewritten after every block, so the file stays valid
+ * even if the process never gets to close() it.
+ */
+class RecordingTap {
+  SndfileHandle file_;
+  SpscRing<float> queue_;
+  std::vector<float> staging_;
+  std::vector<float> block_;
+  std::atomic<bool> running_;
+  std::atomic<uint64_t> droppedSamples_;
+  std::thread writer_;
+
+  void write();
+public:
+  RecordingTap(const std::string& path, uint32_t sampleRate, SampleFormat format, double queueSeconds = 4);
+  virtual ~RecordingTap();
+  /* capture thread: queues a block of normalized samples, never blocks */
+  void push(const Aquila::SampleType* samples, size_t count);
+  /* writes out the queued audio and closes the file; audio pushed afterwards is not written */
+  void close();
+
+  uint64_t getDroppedSamples() const {
+    return droppedSamples_.load(std::memory_order_relaxed);
+  }
+};
+
+#endif /* SRC_RECORDINGTAP_HPP_ */
@@ -0,0 +1,142 @@
+#include "sampleconvert.hpp"
+#include <cstring>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+const double U8_SCALE = 1.0 / 128;
+const double S16_SCALE = 1.0 / 32768;
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+/* stores four 32 bit integers as doubles, scaled and offset */
+static inline void storeScaled(__m128i v, const __m128d scale, const __m128d bias, double* out) {
+  __m128d lo = _mm_cvtepi32_pd(v);
+  __m128d hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  _mm_storeu_pd(out, _mm_add_pd(_mm_mul_pd(lo, scale), bias));
+  _mm_storeu_pd(out + 2, _mm_add_pd(_mm_mul_pd(hi, scale), bias));
+}
+
+static inline void storeScaled(__m128i v, const __m128 scale, const __m128 bias, float* out) {
+  _mm_storeu_ps(out, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), scale), bias));
+}
+#endif
+
+void convertSamples(const uint8_t* in, double* out, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256d scale = _mm256_set1_pd(U8_SCALE);
+  const __m256d bias = _mm256_set1_pd(-1.0);
+  for (; i + 4 <= count; i += 4) {
+    int32_t packed;
+    memcpy(&packed, in + i, sizeof(packed));
+    __m256d v = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+    _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(v, scale), bias));
+  }
+#elif defined(__SSE2__)
+  const __m128d scale = _mm_set1_pd(U8_SCALE);
+  const __m128d bias = _mm_set1_pd(-1.0);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(in + i)), zero);
+    storeScaled(_mm_unpacklo_epi16(v, zero), scale, bias, out + i);
+    storeScaled(_mm_unpackhi_epi16(v, zero), scale, bias, out + i + 4);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = in[i] * U8_SCALE - 1.0;
+  }
+}
+
+void convertSamples(const int16_t* in, double* out, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256d scale = _mm256_set1_pd(S16_SCALE);
+  for (; i + 4 <= count; i += 4) {
+    __m256d v = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(in + i))));
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(v, scale));
+  }
+#elif defined(__SSE2__)
+  const __m128d scale = _mm_set1_pd(S16_SCALE);
+  const __m128d bias = _mm_setzero_pd();
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+    //sign extension: move each value to the upper half and shift back arithmetically
+    storeScaled(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), scale, bias, out + i);
+    storeScaled(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), scale, bias, out + i + 4);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = in[i] * S16_SCALE;
+  }
+}
+
+void convertSamples(const float* in, double* out, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= count; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+  }
+#elif defined(__SSE2__)
+  for (; i + 4 <= count; i += 4) {
+    __m128 v = _mm_loadu_ps(in + i);
+    _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+    _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = in[i];
+  }
+}
+
+void convertSamples(const uint8_t* in, float* out, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256 scale = _mm256_set1_ps(U8_SCALE);
+  const __m256 bias = _mm256_set1_ps(-1.0f);
+  for (; i + 8 <= count; i += 8) {
+    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i))));
+    _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(v, scale), bias));
+  }
+#elif defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(U8_SCALE);
+  const __m128 bias = _mm_set1_ps(-1.0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(in + i)), zero);
+    storeScaled(_mm_unpacklo_epi16(v, zero), scale, bias, out + i);
+    storeScaled(_mm_unpackhi_epi16(v, zero), scale, bias, out + i + 4);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = in[i] * (float)U8_SCALE - 1.0f;
+  }
+}
+
+void convertSamples(const int16_t* in, float* out, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256 scale = _mm256_set1_ps(S16_SCALE);
+  for (; i + 8 <= count; i += 8) {
+    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i))));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(v, scale));
+  }
+#elif defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(S16_SCALE);
+  const __m128 bias = _mm_setzero_ps();
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+    storeScaled(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), scale, bias, out + i);
+    storeScaled(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), scale, bias, out + i + 4);
+  }
+#endif
+  for (; i < count; ++i) {
+    out[i] = in[i] * (float)S16_SCALE;
+  }
+}
+
+void convertSamples(const float* in, float* out, size_t count) {
+  memcpy(out, in, count * sizeof(float));
+}
@@ -0,0 +1,19 @@
+#ifndef SRC_SAMPLECONVERT_HPP_
+#define SRC_SAMPLECONVERT_HPP_
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Block conversion of captured PCM into floating point samples in [-1, 1).
+ * Unsigned 8 bit samples have their +128 offset removed, so the output is
+ * free of the format's DC component. The loops are vectorized with AVX2 or
+ * SSE2 when the compiler targets them.
+ */
+void convertSamples(const uint8_t* in, double* out, size_t count);
+void convertSamples(const int16_t* in, double* out, size_t count);
+void convertSamples(const float* in, double* out, size_t count);
+void convertSamples(const uint8_t* in, float* out, size_t count);
+void convertSamples(const int16_t* in, float* out, size_t count);
+void convertSamples(const float* in, float* out, size_t count);
+
+#endif /* SRC_SAMPLECONVERT_HPP_ */
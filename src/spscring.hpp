@@ -0,0 +1,89 @@
+#ifndef SRC_SPSCRING_HPP_
+#define SRC_SPSCRING_HPP_
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Bounded lock-free ring for exactly one producer and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two. The read and write
+ * positions grow monotonically and are only masked on access, so a full
+ * and an empty ring can be told apart without wasting a slot. Each index
+ * is written by one thread only and published with release semantics;
+ * they are padded a cache line apart to avoid false sharing (padding rather
+ * than alignas, which plain new does not honour before C++17).
+ */
+template<typename T>
+class SpscRing {
+  static size_t roundUp(size_t n) {
+    size_t p = 1;
+    while (p < n)
+      p <<= 1;
+    return p;
+  }
+
+  std::vector<T> data_;
+  size_t mask_;
+  char padding0_[64];
+  std::atomic<size_t> writePos_;
+  char padding1_[64];
+  std::atomic<size_t> readPos_;
+  char padding2_[64];
+public:
+  SpscRing(size_t capacity) :
+      data_(roundUp(capacity)),
+      mask_(data_.size() - 1),
+      writePos_(0),
+      readPos_(0) {
+  }
+
+  size_t capacity() const {
+    return data_.size();
+  }
+
+  /* consumer side: number of elements ready to be read */
+  size_t readAvailable() const {
+    return writePos_.load(std::memory_order_acquire) - readPos_.load(std::memory_order_relaxed);
+  }
+
+  /* producer side: number of free slots */
+  size_t writeAvailable() const {
+    return data_.size() - (writePos_.load(std::memory_order_relaxed) - readPos_.load(std::memory_order_acquire));
+  }
+
+  /* producer side: appends up to count elements, returns how many fit */
+  size_t write(const T* items, size_t count) {
+    const size_t w = writePos_.load(std::memory_order_relaxed);
+    count = std::min(count, data_.size() - (w - readPos_.load(std::memory_order_acquire)));
+    const size_t start = w & mask_;
+    const size_t first = std::min(count, data_.size() - start);
+    std::copy(items, items + first, data_.begin() + start);
+    std::copy(items + first, items + count, data_.begin());
+    writePos_.store(w + count, std::memory_order_release);
+    return count;
+  }
+
+  /* consumer side: removes up to count elements, returns how many were read */
+  size_t read(T* items, size_t count) {
+    const size_t r = readPos_.load(std::memory_order_relaxed);
+    count = std::min(count, writePos_.load(std::memory_order_acquire) - r);
+    const size_t start = r & mask_;
+    const size_t first = std::min(count, data_.size() - start);
+    std::copy(data_.begin() + start, data_.begin() + start + first, items);
+    std::copy(data_.begin(), data_.begin() + (count - first), items + first);
+    readPos_.store(r + count, std::memory_order_release);
+    return count;
+  }
+
+  /* consumer side: discards up to count of the oldest elements */
+  size_t skip(size_t count) {
+    const size_t r = readPos_.load(std::memory_order_relaxed);
+    count = std::min(count, writePos_.load(std::memory_order_acquire) - r);
+    readPos_.store(r + count, std::memory_order_release);
+    return count;
+  }
+};
+
+#endif /* SRC_SPSCRING_HPP_ */
@@ -0,0 +1,127 @@
+#include "streamsources.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include "aquila/source/RawPcmFile.h"
+#include "aquila/source/WaveFile.h"
+#include "aquila/source/generator/PinkNoiseGenerator.h"
+#include "aquila/source/generator/SineGenerator.h"
+#include "sampleconvert.hpp"
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static size_t bytesPerSample(SampleFormat format) {
+  return format == Mono8 ? 1 : format == Mono16 ? 2 : 4;
+}
+
+FileSource::FileSource(RecorderCallback callback, const std::string& path, size_t bufferSize, size_t hop, bool realtime,
+    uint32_t sampleRate, SampleFormat rawFormat) :
+    StreamSource(callback, bufferSize, sampleRate, hop, realtime),
+    format_(rawFormat) {
+  if (endsWith(path, ".wav")) {
+    Aquila::WaveFile wav(path);
+    //WaveFile keeps the integer sample values, 8 bit data already centered
+    double scale = 1.0 / (1 << (wav.getBitsPerSample() - 1));
+    samples_.resize(wav.getSamplesCount());
+    for (size_t i = 0; i < samples_.size(); ++i) {
+      samples_[i] = wav.sample(i) * scale;
+    }
+    format_ = wav.getBitsPerSample() == 8 ? Mono8 : Mono16;
+    setSampleRate(wav.getSampleFrequency());
+  } else if (rawFormat == Mono8) {
+    Aquila::RawPcmFile<uint8_t> raw(path, sampleRate);
+    std::vector<uint8_t> data(raw.begin(), raw.end());
+    samples_.resize(data.size());
+    convertSamples(data.data(), samples_.data(), data.size());
+  } else if (rawFormat == Mono16) {
+    Aquila::RawPcmFile<int16_t> raw(path, sampleRate);
+    std::vector<int16_t> data(raw.begin(), raw.end());
+    samples_.resize(data.size());
+    convertSamples(data.data(), samples_.data(), data.size());
+  } else {
+    Aquila::RawPcmFile<float> raw(path, sampleRate);
+    samples_.assign(raw.begin(), raw.end());
+  }
+
+  if (samples_.empty())
+    std::cerr << "No samples in " << path << std::endl;
+}
+
+size_t FileSource::read(Aquila::SampleType* samples, size_t count) {
+  count = std::min(count, samples_.size() - position_);
+  std::copy(samples_.begin() + position_, samples_.begin() + position_ + count, samples);
+  position_ += count;
+  return count;
+}
+
+PipeSource::PipeSource(RecorderCallback callback, size_t bufferSize, size_t hop, bool realtime,
+    uint32_t sampleRate, SampleFormat format, FILE* input) :
+    StreamSource(callback, bufferSize, sampleRate, hop, realtime),
+    input_(input),
+    format_(format),
+    bytesPerSample_(bytesPerSample(format)) {
+}
+
+size_t PipeSource::read(Aquila::SampleType* samples, size_t count) {
+  raw_.resize(count * bytesPerSample_);
+  //a pipe may deliver short reads, only stop at the end of the stream
+  size_t bytes = 0;
+  while (bytes < raw_.size()) {
+    size_t n = fread(raw_.data() + bytes, 1, raw_.size() - bytes, input_);
+    if (n == 0)
+      break;
+    bytes += n;
+  }
+
+  count = bytes / bytesPerSample_;
+  switch (format_) {
+  case Mono8:
+    convertSamples(reinterpret_cast<const uint8_t*>(raw_.data()), samples, count);
+    break;
+  case Mono16:
+    convertSamples(reinterpret_cast<const int16_t*>(raw_.data()), samples, count);
+    break;
+  case Float32:
+    convertSamples(reinterpret_cast<const float*>(raw_.data()), samples, count);
+    break;
+  }
+  return count;
+}
+
+GeneratorSource::GeneratorSource(RecorderCallback callback, const std::string& type, size_t bufferSize, size_t hop,
+    bool realtime, uint32_t sampleRate, double frequency, double amplitude, double duration) :
+    StreamSource(callback, bufferSize, sampleRate, hop, realtime),
+    periodic_(type == "sine"),
+    frequency_(frequency),
+    remaining_(duration > 0 ? (uint64_t)(duration * sampleRate) : std::numeric_limits<uint64_t>::max()) {
+  if (type == "sine") {
+    generator_.reset(new Aquila::SineGenerator(sampleRate));
+  } else if (type == "pink") {
+    generator_.reset(new Aquila::PinkNoiseGenerator(sampleRate));
+  } else {
+    std::cerr << "Unknown generator: " << type << std::endl;
+    exit(1);
+  }
+  generator_->setFrequency(frequency).setAmplitude(amplitude);
+}
+
+size_t GeneratorSource::read(Aquila::SampleType* samples, size_t count) {
+  count = std::min<uint64_t>(count, remaining_);
+  if (count == 0)
+    return 0;
+
+  //generators start every block at the configured phase, continue the wave instead
+  if (periodic_) {
+    double cycles = frequency_ * position_ / getSampleRate();
+    generator_->setPhase(cycles - floor(cycles));
+  }
+  generator_->generate(count);
+  std::copy(generator_->begin(), generator_->end(), samples);
+
+  position_ += count;
+  remaining_ -= count;
+  return count;
+}
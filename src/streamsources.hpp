@@ -0,0 +1,67 @@
+#ifndef SRC_STREAMSOURCES_HPP_
+#define SRC_STREAMSOURCES_HPP_
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "aquila/source/generator/Generator.h"
+#include "capturesource.hpp"
+
+/*
+ * Streams a WAV file (via Aquila::WaveFile, the sample rate is taken from
+ * the header) or a headerless raw PCM file (via Aquila::RawPcmFile, in the
+ * given format and sample rate). The file is loaded completely up front.
+ */
+class FileSource : public StreamSource {
+  std::vector<Aquila::SampleType> samples_;
+  size_t position_ = 0;
+  SampleFormat format_;
+protected:
+  virtual size_t read(Aquila::SampleType* samples, size_t count);
+public:
+  FileSource(RecorderCallback callback, const std::string& path, size_t bufferSize, size_t hop, bool realtime,
+      uint32_t sampleRate = 44100, SampleFormat rawFormat = Mono16);
+  virtual SampleFormat getFormat() const {
+    return format_;
+  }
+};
+
+/*
+ * Reads raw PCM from a pipe (stdin by default) until end of file.
+ */
+class PipeSource : public StreamSource {
+  FILE* input_;
+  SampleFormat format_;
+  size_t bytesPerSample_;
+  std::vector<char> raw_;
+protected:
+  virtual size_t read(Aquila::SampleType* samples, size_t count);
+public:
+  PipeSource(RecorderCallback callback, size_t bufferSize, size_t hop, bool realtime,
+      uint32_t sampleRate, SampleFormat format, FILE* input = stdin);
+  virtual SampleFormat getFormat() const {
+    return format_;
+  }
+};
+
+/*
+ * Streams the output of an Aquila generator ("sine" or "pink" noise) for
+ * the given duration, or forever when it is 0.
+ */
+class GeneratorSource : public StreamSource {
+  std::unique_ptr<Aquila::Generator> generator_;
+  bool periodic_;
+  double frequency_;
+  uint64_t remaining_;
+  uint64_t position_ = 0;
+protected:
+  virtual size_t read(Aquila::SampleType* samples, size_t count);
+public:
+  GeneratorSource(RecorderCallback callback, const std::string& type, size_t bufferSize, size_t hop, bool realtime,
+      uint32_t sampleRate, double frequency, double amplitude, double duration);
+  virtual SampleFormat getFormat() const {
+    return Float32;
+  }
+};
+
+#endif /* SRC_STREAMSOURCES_HPP_ */
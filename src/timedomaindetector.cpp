@@ -0,0 +1,215 @@
+#include "timedomaindetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include "aquila/transform/FftFactory.h"
+
+//about -60 dB relative to full scale
+const double MIN_RMS = 0.001;
+
+static size_t nextPowerOfTwo(size_t n) {
+  size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+Autocorrelation::Autocorrelation(size_t size) :
+    size_(size),
+    //padding to at least 2N keeps the circular correlation from wrapping around
+    paddedSize_(nextPowerOfTwo(2 * size)),
+    fft_(Aquila::FftFactory::getFft(paddedSize_)),
+    padded_(paddedSize_, 0.0),
+    spectrum_(paddedSize_ / 2 + 1),
+    head_(paddedSize_ / 2 + 1) {
+}
+
+void Autocorrelation::compute(const Aquila::SampleType* samples, Aquila::SampleType* result, size_t length) {
+  std::copy(samples, samples + size_, padded_.begin());
+  std::fill(padded_.begin() + size_, padded_.end(), 0.0);
+  fft_->rfft(padded_.data(), spectrum_.data());
+
+  if (length == 0 || length >= size_) {
+    for (size_t i = 0; i < spectrum_.size(); ++i) {
+      spectrum_[i] = std::norm(spectrum_[i]);
+    }
+  } else {
+    //cross correlation of the leading samples with the whole frame
+    std::fill(padded_.begin() + length, padded_.begin() + size_, 0.0);
+    fft_->rfft(padded_.data(), head_.data());
+    for (size_t i = 0; i < spectrum_.size(); ++i) {
+      spectrum_[i] *= std::conj(head_[i]);
+    }
+  }
+  fft_->irfft(spectrum_.data(), padded_.data());
+
+  std::copy(padded_.begin(), padded_.begin() + size_, result);
+}
+
+TimeDomainPitchDetector::TimeDomainPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency,
+    double maxFrequency, double threshold) :
+    PitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency),
+    autocorrelation_(bufferSize),
+    frame_(bufferSize),
+    acf_(bufferSize),
+    function_(bufferSize / 2 + 1),
+    minLag_(std::max<size_t>(2, (size_t)floor(sampleRate / maxFrequency))),
+    //both methods need at least two periods inside the frame
+    maxLag_(std::min<size_t>(bufferSize / 2, (size_t)ceil(sampleRate / std::max(minFrequency, 1.0)))),
+    threshold_(threshold) {
+}
+
+TimeDomainPitchDetector::~TimeDomainPitchDetector() {
+}
+
+double TimeDomainPitchDetector::prepare(const Aquila::SampleType* samples) {
+  double mean = 0;
+  for (size_t i = 0; i < bufferSize_; ++i) {
+    mean += samples[i];
+  }
+  mean /= bufferSize_;
+
+  double energy = 0;
+  for (size_t i = 0; i < bufferSize_; ++i) {
+    frame_[i] = samples[i] - mean;
+    energy += frame_[i] * frame_[i];
+  }
+  return energy;
+}
+
+double TimeDomainPitchDetector::interpolate(size_t lag) const {
+  if (lag == 0 || lag + 1 >= function_.size())
+    return lag;
+
+  double a = function_[lag - 1];
+  double b = function_[lag];
+  double c = function_[lag + 1];
+  double denominator = a - 2 * b + c;
+  if (denominator == 0)
+    return lag;
+
+  double delta = 0.5 * (a - c) / denominator;
+  return lag + std::max(-0.5, std::min(0.5, delta));
+}
+
+YinPitchDetector::YinPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency, double maxFrequency,
+    double threshold) :
+    TimeDomainPitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency, threshold),
+    energy_(bufferSize + 1) {
+}
+
+YinPitchDetector::~YinPitchDetector() {
+}
+
+bool YinPitchDetector::process(const Aquila::SampleType* samples, PitchEstimate& estimate) {
+  double energy = prepare(samples);
+  estimate.totalPower = energy / bufferSize_;
+  estimate.magnitude = sqrt(estimate.totalPower);
+  if (estimate.magnitude <= MIN_RMS || minLag_ >= maxLag_)
+    return false;
+
+  //prefix sums of squares give the energy of any window in O(1)
+  energy_[0] = 0;
+  for (size_t i = 0; i < bufferSize_; ++i) {
+    energy_[i + 1] = energy_[i] + frame_[i] * frame_[i];
+  }
+
+  //difference function over an integration window of W = N - maxLag samples:
+  //d(t) = sum x(j)^2 + sum x(j+t)^2 - 2 r(t), j = 0 .. W - 1
+  size_t window = bufferSize_ - maxLag_;
+  autocorrelation_.compute(frame_.data(), acf_.data(), window);
+
+  double running = 0;
+  function_[0] = 1;
+  for (size_t lag = 1; lag <= maxLag_; ++lag) {
+    double d = energy_[window] + (energy_[lag + window] - energy_[lag]) - 2 * acf_[lag];
+    d = std::max(0.0, d);
+    running += d;
+    //cumulative mean normalized difference
+    function_[lag] = running > 0 ? d * lag / running : 1;
+  }
+
+  size_t best = 0;
+  for (size_t lag = minLag_; lag < maxLag_; ++lag) {
+    if (function_[lag] < threshold_) {
+      while (lag + 1 < maxLag_ && function_[lag + 1] < function_[lag])
+        ++lag;
+      best = lag;
+      break;
+    }
+  }
+  if (best == 0)
+    return false;
+
+  estimate.confidence = 1 - std::min(1.0, function_[best]);
+  return setFrequency(sampleRate_ / interpolate(best), estimate);
+}
+
+McLeodPitchDetector::McLeodPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency,
+    double maxFrequency, double threshold) :
+    TimeDomainPitchDetector(bufferSize, sampleRate, minFrequency, maxFrequency, threshold) {
+}
+
+McLeodPitchDetector::~McLeodPitchDetector() {
+}
+
+bool McLeodPitchDetector::process(const Aquila::SampleType* samples, PitchEstimate& estimate) {
+  double energy = prepare(samples);
+  estimate.totalPower = energy / bufferSize_;
+  estimate.magnitude = sqrt(estimate.totalPower);
+  if (estimate.magnitude <= MIN_RMS || minLag_ >= maxLag_)
+    return false;
+
+  autocorrelation_.compute(frame_.data(), acf_.data());
+
+  //normalized square difference function: n(t) = 2 r(t) / m(t),
+  //m(t) = sum of x(j)^2 + x(j+t)^2 shrinks by two samples per lag;
+  //one lag past maxLag is kept when it fits, interpolate() reads it
+  size_t lastLag = std::min(maxLag_ + 1, function_.size() - 1);
+  double m = 2 * energy;
+  function_[0] = 1;
+  for (size_t lag = 1; lag <= lastLag; ++lag) {
+    m -= frame_[lag - 1] * frame_[lag - 1] + frame_[bufferSize_ - lag] * frame_[bufferSize_ - lag];
+    function_[lag] = m > 0 ? 2 * acf_[lag] / m : 0;
+  }
+
+  //key maxima: the highest point between each positive going zero crossing
+  //and the following negative going one
+  size_t lag = 1;
+  while (lag <= maxLag_ && function_[lag] > 0)
+    ++lag;
+
+  double highest = 0;
+  size_t best = 0;
+  size_t candidate = 0;
+  bool positive = false;
+  //first pass finds the highest key maximum, the second picks the earliest close to it
+  for (int pass = 0; pass < 2 && best == 0; ++pass) {
+    for (size_t i = lag; i <= maxLag_; ++i) {
+      if (!positive && function_[i] > 0) {
+        positive = true;
+        candidate = i;
+      } else if (positive && function_[i] <= 0) {
+        positive = false;
+      }
+      if (positive && function_[i] > function_[candidate])
+        candidate = i;
+
+      bool keyMaximum = positive && (i == maxLag_ || function_[i + 1] <= 0) && candidate >= minLag_;
+      if (!keyMaximum)
+        continue;
+
+      if (pass == 0) {
+        highest = std::max(highest, function_[candidate]);
+      } else if (function_[candidate] >= threshold_ * highest) {
+        best = candidate;
+        break;
+      }
+    }
+    positive = false;
+  }
+  if (best == 0 || highest <= 0)
+    return false;
+
+  estimate.confidence = function_[best];
+  return setFrequency(sampleRate_ / interpolate(best), estimate);
+}
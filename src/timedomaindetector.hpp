@@ -0,0 +1,78 @@
+#ifndef SRC_TIMEDOMAINDETECTOR_HPP_
+#define SRC_TIMEDOMAINDETECTOR_HPP_
+#include <memory>
+#include <vector>
+#include "pitchdetector.hpp"
+
+/*
+ * Computes the linear (not circular) autocorrelation of a frame through
+ * a zero padded real FFT, in O(N log N) instead of O(N * maxLag).
+ * Plans and buffers are created once for the frame size.
+ */
+class Autocorrelation {
+  size_t size_;
+  size_t paddedSize_;
+  std::shared_ptr<Aquila::Fft> fft_;
+  std::vector<Aquila::SampleType> padded_;
+  Aquila::SpectrumType spectrum_;
+  Aquila::SpectrumType head_;
+public:
+  Autocorrelation(size_t size);
+  /*
+   * writes r(t) = sum x(j) * x(j + t) for t = 0 .. size - 1 into result,
+   * with j running over the first length samples only (the whole frame by default)
+   */
+  void compute(const Aquila::SampleType* samples, Aquila::SampleType* result, size_t length = 0);
+};
+
+/*
+ * Base for detectors looking for the period of the signal in the lag
+ * domain. Removes the DC offset of each frame and restricts the lag
+ * search to the configured frequency range.
+ */
+class TimeDomainPitchDetector : public PitchDetector {
+protected:
+  Autocorrelation autocorrelation_;
+  std::vector<Aquila::SampleType> frame_;
+  std::vector<Aquila::SampleType> acf_;
+  std::vector<double> function_;
+  size_t minLag_;
+  size_t maxLag_;
+  double threshold_;
+
+  /* mean-free copy of the samples into frame_, returns its energy */
+  double prepare(const Aquila::SampleType* samples);
+  /* refines the extremum at lag using its two neighbours in function_ */
+  double interpolate(size_t lag) const;
+public:
+  TimeDomainPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency, double maxFrequency,
+      double threshold);
+  virtual ~TimeDomainPitchDetector();
+};
+
+/*
+ * YIN (de Cheveigne, Kawahara 2002): the first dip of the cumulative mean
+ * normalized difference function below the threshold.
+ */
+class YinPitchDetector : public TimeDomainPitchDetector {
+  std::vector<double> energy_;
+public:
+  YinPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency = 200, double maxFrequency = 22050,
+      double threshold = 0.1);
+  virtual ~YinPitchDetector();
+  virtual bool process(const Aquila::SampleType* samples, PitchEstimate& estimate);
+};
+
+/*
+ * McLeod pitch method (McLeod, Wyvill 2005): the first key maximum of the
+ * normalized square difference function that comes close to the highest one.
+ */
+class McLeodPitchDetector : public TimeDomainPitchDetector {
+public:
+  McLeodPitchDetector(size_t bufferSize, uint32_t sampleRate, double minFrequency = 200, double maxFrequency = 22050,
+      double threshold = 0.9);
+  virtual ~McLeodPitchDetector();
+  virtual bool process(const Aquila::SampleType* samples, PitchEstimate& estimate);
+};
+
+#endif /* SRC_TIMEDOMAINDETECTOR_HPP_ */
@@ -78,7 +78,7 @@ namespace Aquila
         /**
          * Filter spectrum (real-valued).
          */
-        std::vector<double> m_spectrum;
+        std::vector<SampleType> m_spectrum;
 
         void generateFilterSpectrum(FrequencyType minFreq,
                                     FrequencyType centerFreq,
@@ -31,6 +31,16 @@
 #    define AQUILA_EXPORT
 #endif
 
+/**
+ * Marks pointers which never alias each other, so that loops over them
+ * vectorize without runtime overlap checks.
+ */
+#if defined(__GNUC__) || defined(_MSC_VER)
+#    define AQUILA_RESTRICT __restrict
+#else
+#    define AQUILA_RESTRICT
+#endif
+
 /**
  * Main library namespace.
  */
@@ -48,8 +58,18 @@ namespace Aquila
 
     /**
      * Sample value type.
+     *
+     * Double precision by default. Building with AQUILA_SINGLE_PRECISION
+     * defined (the Aquila_SINGLE_PRECISION CMake option) switches samples
+     * and spectra to float, which halves the memory traffic and doubles
+     * the SIMD lane count. The define must be the same for the library
+     * and every program using it.
      */
+#ifdef AQUILA_SINGLE_PRECISION
+    typedef float SampleType;
+#else
     typedef double SampleType;
+#endif
 
     /**
      * Sample frequency type.
@@ -57,9 +77,9 @@ namespace Aquila
     typedef double FrequencyType;
 
     /**
-     * Our standard complex number type, using double precision.
+     * Our standard complex number type, with the precision of samples.
      */
-    typedef std::complex<double> ComplexType;
+    typedef std::complex<SampleType> ComplexType;
 
     /**
      * Spectrum type - a vector of complex values.
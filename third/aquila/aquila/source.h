@@ -22,6 +22,7 @@
 #include "source/SignalSource.h"
 #include "source/Frame.h"
 #include "source/FramesCollection.h"
+#include "source/FrameView.h"
 #include "source/PlainTextFile.h"
 #include "source/RawPcmFile.h"
 #include "source/WaveFile.h"
@@ -39,5 +40,6 @@
 #include "source/window/HammingWindow.h"
 #include "source/window/HannWindow.h"
 #include "source/window/RectangularWindow.h"
+#include "source/window/WindowCache.h"
 
 #endif // AQUILA_SOURCE_H
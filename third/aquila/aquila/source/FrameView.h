@@ -0,0 +1,331 @@
+/**
+ * @file FrameView.h
+ *
+ * Non-owning views of signal frames and a lazy sequence of them.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef FRAMEVIEW_H
+#define FRAMEVIEW_H
+
+#include "../global.h"
+#include <cstddef>
+#include <iterator>
+
+namespace Aquila
+{
+    /**
+     * A frame as a pointer to its first sample and a length.
+     *
+     * Unlike Frame, a view is not a SignalSource: it has no virtual
+     * methods, no sample storage of its own and no back pointer, just
+     * two words, so it is free to create and copy. Samples are read
+     * directly from the array of the original signal, which must outlive
+     * the view.
+     *
+     * A view is read-only. To window a frame, multiply it into a scratch
+     * buffer with applyWindow() and transform the buffer.
+     */
+    class FrameView
+    {
+    public:
+        /**
+         * Creates an empty view.
+         */
+        FrameView():
+            m_data(nullptr), m_length(0)
+        {
+        }
+
+        /**
+         * Creates a view of length samples starting at data.
+         *
+         * @param data first sample of the frame
+         * @param length number of samples
+         */
+        FrameView(const SampleType* data, std::size_t length):
+            m_data(data), m_length(length)
+        {
+        }
+
+        /**
+         * Returns the frame length.
+         *
+         * @return frame length as a number of samples
+         */
+        std::size_t length() const
+        {
+            return m_length;
+        }
+
+        /**
+         * Returns sample data as a C-style array.
+         *
+         * @return pointer to the first sample
+         */
+        const SampleType* toArray() const
+        {
+            return m_data;
+        }
+
+        /**
+         * Gives access to frame samples, indexed from 0 to length()-1.
+         *
+         * @param position index of the sample in the frame
+         * @return sample value
+         */
+        SampleType operator[](std::size_t position) const
+        {
+            return m_data[position];
+        }
+
+        /**
+         * Returns a pointer to the first sample.
+         *
+         * @return begin iterator
+         */
+        const SampleType* begin() const
+        {
+            return m_data;
+        }
+
+        /**
+         * Returns a pointer one past the last sample.
+         *
+         * @return end iterator
+         */
+        const SampleType* end() const
+        {
+            return m_data + m_length;
+        }
+
+        /**
+         * Multiplies the frame by a window, writing the result elsewhere.
+         *
+         * @param window length() window coefficients
+         * @param out output buffer for length() samples
+         */
+        void applyWindow(const SampleType* AQUILA_RESTRICT window,
+                         SampleType* AQUILA_RESTRICT out) const
+        {
+            const SampleType* AQUILA_RESTRICT in = m_data;
+            for (std::size_t i = 0; i < m_length; ++i)
+            {
+                out[i] = in[i] * window[i];
+            }
+        }
+
+    private:
+        /**
+         * First sample of the frame.
+         */
+        const SampleType* m_data;
+
+        /**
+         * Number of samples.
+         */
+        std::size_t m_length;
+    };
+
+    /**
+     * A forward iterator creating frame views as it advances.
+     */
+    class FrameViewIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef FrameView value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const FrameView* pointer;
+        typedef FrameView reference;
+
+        /**
+         * Creates an iterator at a given frame.
+         *
+         * @param data first sample of the frame
+         * @param length samples per frame
+         * @param hop distance between starts of consecutive frames
+         */
+        FrameViewIterator(const SampleType* data, std::size_t length,
+                          std::size_t hop):
+            m_data(data), m_length(length), m_hop(hop)
+        {
+        }
+
+        FrameView operator*() const
+        {
+            return FrameView(m_data, m_length);
+        }
+
+        FrameViewIterator& operator++()
+        {
+            m_data += m_hop;
+            return *this;
+        }
+
+        FrameViewIterator operator++(int)
+        {
+            FrameViewIterator previous(*this);
+            m_data += m_hop;
+            return previous;
+        }
+
+        bool operator==(const FrameViewIterator& other) const
+        {
+            return m_data == other.m_data;
+        }
+
+        bool operator!=(const FrameViewIterator& other) const
+        {
+            return m_data != other.m_data;
+        }
+
+    private:
+        /**
+         * First sample of the current frame.
+         */
+        const SampleType* m_data;
+
+        /**
+         * Samples per frame.
+         */
+        std::size_t m_length;
+
+        /**
+         * Distance between starts of consecutive frames.
+         */
+        std::size_t m_hop;
+    };
+
+    /**
+     * Equally spaced frames of a signal array, produced on demand.
+     *
+     * Nothing is stored besides the signal pointer and the frame layout;
+     * views are created by the iterators or by indexing. The hop must not
+     * be zero.
+     */
+    class FrameViewRange
+    {
+    public:
+        /**
+         * Iterator type.
+         */
+        typedef FrameViewIterator const_iterator;
+
+        /**
+         * Creates an empty range.
+         */
+        FrameViewRange():
+            m_data(nullptr), m_count(0), m_length(0), m_hop(0)
+        {
+        }
+
+        /**
+         * Creates a range of frames.
+         *
+         * @param data first sample of the first frame
+         * @param count number of frames
+         * @param length samples per frame
+         * @param hop distance between starts of consecutive frames
+         */
+        FrameViewRange(const SampleType* data, std::size_t count,
+                       std::size_t length, std::size_t hop):
+            m_data(data), m_count(count), m_length(length), m_hop(hop)
+        {
+        }
+
+        /**
+         * Returns number of frames.
+         *
+         * @return frame count
+         */
+        std::size_t count() const
+        {
+            return m_count;
+        }
+
+        /**
+         * Returns number of samples in each frame.
+         *
+         * @return frame size in samples
+         */
+        std::size_t getSamplesPerFrame() const
+        {
+            return m_length;
+        }
+
+        /**
+         * Returns distance between starts of consecutive frames.
+         *
+         * @return hop size in samples
+         */
+        std::size_t getHop() const
+        {
+            return m_hop;
+        }
+
+        /**
+         * Returns a view of the nth frame.
+         *
+         * @param index frame number
+         * @return frame view
+         */
+        FrameView operator[](std::size_t index) const
+        {
+            return FrameView(m_data + index * m_hop, m_length);
+        }
+
+        /**
+         * Returns an iterator pointing to the first frame.
+         *
+         * @return iterator
+         */
+        const_iterator begin() const
+        {
+            return const_iterator(m_data, m_length, m_hop);
+        }
+
+        /**
+         * Returns an iterator pointing one-past-last frame.
+         *
+         * @return iterator
+         */
+        const_iterator end() const
+        {
+            return const_iterator(m_data + m_count * m_hop, m_length, m_hop);
+        }
+
+    private:
+        /**
+         * First sample of the first frame.
+         */
+        const SampleType* m_data;
+
+        /**
+         * Number of frames.
+         */
+        std::size_t m_count;
+
+        /**
+         * Samples per frame.
+         */
+        std::size_t m_length;
+
+        /**
+         * Distance between starts of consecutive frames.
+         */
+        std::size_t m_hop;
+    };
+}
+
+#endif // FRAMEVIEW_H
@@ -17,6 +17,7 @@
 
 #include "FramesCollection.h"
 #include "SignalSource.h"
+#include "../Exceptions.h"
 
 namespace Aquila
 {
@@ -24,7 +25,7 @@ namespace Aquila
      * Creates an empty frames collection.
      */
     FramesCollection::FramesCollection():
-        m_frames(), m_samplesPerFrame(0)
+        m_frames(), m_samplesPerFrame(0), m_samplesPerHop(0)
     {
     }
 
@@ -38,7 +39,7 @@ namespace Aquila
     FramesCollection::FramesCollection(const SignalSource& source,
                                        unsigned int samplesPerFrame,
                                        unsigned int samplesPerOverlap):
-        m_frames(), m_samplesPerFrame(0)
+        m_frames(), m_samplesPerFrame(0), m_samplesPerHop(0)
     {
         divideFrames(source, samplesPerFrame, samplesPerOverlap);
     }
@@ -70,6 +71,40 @@ namespace Aquila
         return FramesCollection(source, samplesPerFrame, samplesPerOverlap);
     }
 
+    /**
+     * Divides the source into frames without creating a collection.
+     *
+     * The frames are the same as those of a collection created with the
+     * same arguments, but they are produced on demand as views of the
+     * source samples. The source must outlive the returned range.
+     *
+     * @param source a reference to source object
+     * @param samplesPerFrame how many samples will each frame hold
+     * @param samplesPerOverlap how many samples are common to adjacent frames
+     * @return range of frame views
+     * @throw Aquila::ConfigurationException when overlap is not less than
+     *        frame length
+     */
+    FrameViewRange FramesCollection::divideViews(const SignalSource& source,
+                                                 unsigned int samplesPerFrame,
+                                                 unsigned int samplesPerOverlap)
+    {
+        if (samplesPerFrame == 0)
+        {
+            return FrameViewRange();
+        }
+        if (samplesPerOverlap >= samplesPerFrame)
+        {
+            throw ConfigurationException("Overlap must be shorter than the frame!");
+        }
+        const std::size_t sourceSize = source.getSamplesCount();
+        const unsigned int nonOverlapped = samplesPerFrame - samplesPerOverlap;
+        const std::size_t framesCount = sourceSize < samplesPerFrame ? 0 :
+            (sourceSize - samplesPerFrame) / nonOverlapped + 1;
+        return FrameViewRange(source.toArray(), framesCount,
+                              samplesPerFrame, nonOverlapped);
+    }
+
     /**
      * Performs the actual frame division.
      *
@@ -90,6 +125,7 @@ namespace Aquila
             return;
         }
         m_samplesPerFrame = samplesPerFrame;
+        m_samplesPerHop = samplesPerFrame - samplesPerOverlap;
         const std::size_t sourceSize = source.getSamplesCount();
         const unsigned int nonOverlapped = samplesPerFrame - samplesPerOverlap;
         const unsigned int framesCount = sourceSize / nonOverlapped;
@@ -20,6 +20,7 @@
 
 #include "../global.h"
 #include "Frame.h"
+#include "FrameView.h"
 #include <algorithm>
 #include <cstddef>
 #include <functional>
@@ -46,6 +47,10 @@ namespace Aquila
      * Individual frame objects can by accessed by iterating over the collection
      * using begin() and end() methods. These calls simply return iterators
      * pointing to the underlying container.
+     *
+     * Code which only reads frame samples should prefer views(), which yields
+     * non-virtual FrameView objects, or divideViews(), which does the same
+     * without building a collection at all.
      */
     class AQUILA_EXPORT FramesCollection
     {
@@ -75,11 +80,30 @@ namespace Aquila
                                                    double frameDuration,
                                                    double overlap = 0.0);
 
+        static FrameViewRange divideViews(const SignalSource& source,
+                                          unsigned int samplesPerFrame,
+                                          unsigned int samplesPerOverlap = 0);
+
         void divideFrames(const SignalSource& source,
                           unsigned int samplesPerFrame,
                           unsigned int samplesPerOverlap = 0);
         void clear();
 
+        /**
+         * Returns lightweight views of all frames in the collection.
+         *
+         * @return range of frame views
+         */
+        FrameViewRange views() const
+        {
+            if (m_frames.empty())
+            {
+                return FrameViewRange();
+            }
+            return FrameViewRange(m_frames.front().toArray(), m_frames.size(),
+                                  m_samplesPerFrame, m_samplesPerHop);
+        }
+
         /**
          * Returns number of frames in the collection.
          *
@@ -176,6 +200,11 @@ namespace Aquila
          * Number of samples in each frame.
          */
         unsigned int m_samplesPerFrame;
+
+        /**
+         * Distance between starts of consecutive frames.
+         */
+        unsigned int m_samplesPerHop;
     };
 }
 
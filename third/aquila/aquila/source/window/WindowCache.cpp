@@ -0,0 +1,104 @@
+/**
+ * @file WindowCache.cpp
+ *
+ * Process-wide cache of window coefficient tables.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "WindowCache.h"
+#include "BarlettWindow.h"
+#include "BlackmanWindow.h"
+#include "FlattopWindow.h"
+#include "GaussianWindow.h"
+#include "HammingWindow.h"
+#include "HannWindow.h"
+#include "RectangularWindow.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace Aquila
+{
+    namespace
+    {
+        /**
+         * Copies the coefficients of a window object.
+         */
+        WindowCache::Table copy(const SignalSource& window)
+        {
+            WindowCache::Table table(window.getSamplesCount());
+            for (std::size_t n = 0; n < table.size(); ++n)
+            {
+                table[n] = window.sample(n);
+            }
+            return table;
+        }
+
+        /**
+         * Computes the coefficients of a window.
+         */
+        WindowCache::Table build(WindowCache::WindowType type, std::size_t size,
+                                 double parameter)
+        {
+            switch (type)
+            {
+            case WindowCache::Barlett:
+                return copy(BarlettWindow(size));
+            case WindowCache::Blackman:
+                return copy(BlackmanWindow(size));
+            case WindowCache::Flattop:
+                return copy(FlattopWindow(size));
+            case WindowCache::Gaussian:
+                return copy(GaussianWindow(size, parameter));
+            case WindowCache::Hamming:
+                return copy(HammingWindow(size));
+            case WindowCache::Hann:
+                return copy(HannWindow(size));
+            default:
+                return copy(RectangularWindow(size));
+            }
+        }
+    }
+
+    /**
+     * Returns the shared coefficient table of a window.
+     *
+     * Thread safe. Takes a lock, so call it when setting up, not from
+     * real-time code.
+     *
+     * @param type window type
+     * @param size window length
+     * @param parameter window parameter (sigma of the Gaussian window,
+     *        ignored by the other types)
+     * @return immutable table of size coefficients
+     */
+    std::shared_ptr<const WindowCache::Table> WindowCache::get(
+        WindowType type, std::size_t size, double parameter)
+    {
+        typedef std::tuple<int, std::size_t, double> Key;
+        static std::mutex mutex;
+        static std::map<Key, std::shared_ptr<const Table>> tables;
+
+        if (Gaussian != type)
+        {
+            parameter = 0.0;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const Table>& table = tables[Key(type, size, parameter)];
+        if (!table)
+        {
+            table = std::make_shared<const Table>(build(type, size, parameter));
+        }
+        return table;
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * @file WindowCache.h
+ *
+ * Process-wide cache of window coefficient tables.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef WINDOWCACHE_H
+#define WINDOWCACHE_H
+
+#include "../../global.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Aquila
+{
+    /**
+     * Shares window coefficients between all their users.
+     *
+     * The window classes compute their coefficients (with std::cos and the
+     * like) every time they are constructed. Code which needs the same
+     * window over and over should take its table from this cache instead:
+     * each distinct (type, size, parameter) table is computed once, by the
+     * window class itself, and kept for the lifetime of the process.
+     *
+     * Tables are immutable, so any number of threads may read them.
+     */
+    class AQUILA_EXPORT WindowCache
+    {
+    public:
+        /**
+         * Available window types.
+         */
+        enum WindowType {Rectangular, Barlett, Blackman, Flattop, Gaussian, Hamming, Hann};
+
+        /**
+         * Window coefficients.
+         */
+        typedef std::vector<SampleType> Table;
+
+        static std::shared_ptr<const Table> get(WindowType type, std::size_t size,
+                                                double parameter = 0.5);
+    };
+}
+
+#endif // WINDOWCACHE_H
@@ -23,9 +23,14 @@
 #include "transform/Dft.h"
 #include "transform/AquilaFft.h"
 #include "transform/OouraFft.h"
+#include "transform/FixedFft.h"
+#include "transform/SimdFft.h"
 #include "transform/FftFactory.h"
 #include "transform/Dct.h"
 #include "transform/Mfcc.h"
+#include "transform/PeakPicker.h"
 #include "transform/Spectrogram.h"
+#include "transform/ParallelSpectrogram.h"
+#include "transform/StreamingSpectrogram.h"
 
 #endif // AQUILA_TRANSFORM_H
@@ -16,199 +16,265 @@
  */
 
 #include "AquilaFft.h"
+#include "PlanCache.h"
+#include "RealSplit.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
 
 namespace Aquila
 {
-    /**
-     * Complex unit.
-     */
-    const ComplexType AquilaFft::j(0, 1);
+    namespace
+    {
+        /**
+         * Lists the index pairs a bit reversal of length values exchanges.
+         */
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> bitReversalSwaps(std::size_t length)
+        {
+            const std::vector<std::uint32_t> reversed = bitReversedIndices(length);
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> swaps;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                if (i < reversed[i])
+                {
+                    swaps.push_back(std::make_pair(static_cast<std::uint32_t>(i), reversed[i]));
+                }
+            }
+            return swaps;
+        }
+    }
 
     /**
-     * Applies the transformation to the signal.
+     * Builds the twiddles and bit reversal swaps of one length.
      *
-     * @param x input signal
-     * @return calculated spectrum
+     * Every twiddle is computed directly (not by a recurrence) in double
+     * precision, so their accuracy does not depend on the length.
+     *
+     * @param length transform length, a power of 2
      */
-    SpectrumType AquilaFft::fft(const SampleType x[])
+    AquilaFft::Tables::Tables(std::size_t length):
+        twiddles(length > 1 ? length - 1 : 0),
+        swaps(bitReversalSwaps(length)),
+        halfSwaps(bitReversalSwaps(length / 2))
     {
-        SpectrumType spectrum(N);
-
-        // bit-reversing the samples - a requirement of radix-2
-        // instead of reversing in place, put the samples to result array
-        unsigned int a = 1, b = 0, c = 0;
-        std::copy(x, x + N, std::begin(spectrum));
-        for (b = 1; b < N; ++b)
+        for (std::size_t M = 1; M < length; M *= 2)
         {
-            if (b < a)
-            {
-                spectrum[a - 1] = x[b - 1];
-                spectrum[b - 1] = x[a - 1];
-            }
-            c = N / 2;
-            while (c < a)
+            for (std::size_t p = 0; p < M; ++p)
             {
-                a -= c;
-                c /= 2;
+                twiddles[M - 1 + p] = ComplexType(
+                    std::polar(1.0, -M_PI * static_cast<double>(p) / static_cast<double>(M)));
             }
-            a += c;
         }
+    }
 
-        // FFT calculation using "butterflies"
-        // code ported from Matlab, based on book by Tomasz P. Zieliński
-
-        // FFT stages count
-        unsigned int numStages = static_cast<unsigned int>(
-            std::log(static_cast<double>(N)) / LN_2);
-
-        // L = 2^k - DFT block length and offset
-        // M = 2^(k-1) - butterflies per block, butterfly width
-        // p - butterfly index
-        // q - block index
-        // r - index of sample in butterfly
-        // Wi - starting value of Fourier base coefficient
-        unsigned int L = 0, M = 0, p = 0, q = 0, r = 0;
-        ComplexType Wi(0, 0), Temp(0, 0);
-
-        ComplexType** Wi_cache = getCachedFftWi(numStages);
+    /**
+     * Initializes the transform for a given input length.
+     *
+     * @param length input signal size, a power of 2
+     */
+    AquilaFft::AquilaFft(std::size_t length):
+        Fft(length), m_tables(PlanCache<Tables>::get(length)),
+        m_work(length / 2 + 1)
+    {
+    }
 
-        // iterate over the stages
-        for (unsigned int k = 1; k <= numStages; ++k)
+    /**
+     * Applies the transformation to the signal.
+     *
+     * Computes the real transform and fills the upper half of the spectrum
+     * by conjugate symmetry.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N bins)
+     */
+    void AquilaFft::fft(const SampleType x[], ComplexType spectrum[])
+    {
+        rfft(x, spectrum);
+        for (std::size_t k = N / 2 + 1; k < N; ++k)
         {
-            L = 1 << k;
-            M = 1 << (k - 1);
-            Wi = Wi_cache[k][0];
-
-            // iterate over butterflies
-            for (p = 1; p <= M; ++p)
-            {
-                // iterate over blocks
-                for (q = p; q <= N; q += L)
-                {
-                    r = q + M;
-                    Temp = spectrum[r - 1] * Wi;
-                    spectrum[r - 1] = spectrum[q - 1] - Temp;
-                    spectrum[q - 1] = spectrum[q - 1] + Temp;
-                }
-                Wi = Wi_cache[k][p];
-            }
+            spectrum[k] = std::conj(spectrum[N - k]);
         }
-
-        return spectrum;
     }
 
     /**
      * Applies the inverse transform to the spectrum.
      *
-     * @param spectrum input spectrum
+     * The real part of the inverse transform of any spectrum equals the
+     * inverse transform of its conjugate-symmetric part, which is what is
+     * computed here - with a real transform of half the work.
+     *
+     * @param spectrum input spectrum (N bins)
      * @param x output signal
      */
-    void AquilaFft::ifft(SpectrumType spectrum, double x[])
+    void AquilaFft::ifft(const ComplexType spectrum[], SampleType x[])
     {
-        SpectrumType spectrumCopy(spectrum);
-        unsigned int a = 1, b = 0, c = 0;
-        for (b = 1; b < N; ++b)
+        const std::size_t M = N / 2;
+        m_work[0] = ComplexType(spectrum[0].real());
+        for (std::size_t k = 1; k <= M; ++k)
         {
-            if (b < a)
-            {
-                spectrumCopy[a - 1] = spectrum[b - 1];
-                spectrumCopy[b - 1] = spectrum[a - 1];
-            }
-            c = N / 2;
-            while (c < a)
-            {
-                a -= c;
-                c /= 2;
-            }
-            a += c;
+            m_work[k] = SampleType(0.5) * (spectrum[k] + std::conj(spectrum[N - k]));
         }
+        irfft(&m_work[0], x);
+    }
 
-        unsigned int numStages = static_cast<unsigned int>(
-            std::log(static_cast<double>(N)) / LN_2);
-        unsigned int L = 0, M = 0, p = 0, q = 0, r = 0;
-        ComplexType Wi(0, 0), Temp(0, 0);
-        ComplexType** Wi_cache = getCachedFftWi(numStages);
-        for (unsigned int k = 1; k <= numStages; ++k)
-        {
-            L = 1 << k;
-            M = 1 << (k - 1);
-            Wi = -Wi_cache[k][0];
-            for (p = 1; p <= M; ++p)
-            {
-                for (q = p; q <= N; q += L)
-                {
-                    r = q + M;
-                    Temp = spectrumCopy[r - 1] * Wi;
-                    spectrumCopy[r - 1] = spectrumCopy[q - 1] - Temp;
-                    spectrumCopy[q - 1] = spectrumCopy[q - 1] + Temp;
-                }
-                Wi = -Wi_cache[k][p];
-            }
-        }
+    /**
+     * Applies the transformation to a real signal.
+     *
+     * The samples are copied into the output as N/2 complex values (even
+     * samples as real parts, odd ones as imaginary parts), transformed in
+     * place and split into N/2+1 bins, also in place.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void AquilaFft::rfft(const SampleType x[], ComplexType spectrum[])
+    {
+        std::copy(x, x + N, reinterpret_cast<SampleType*>(spectrum));
+        transformReal(spectrum);
+    }
 
-        for (unsigned int k = 0; k < N; ++k)
-        {
-            x[k] = std::abs(spectrumCopy[k]) / static_cast<double>(N);
-        }
+    /**
+     * Applies the real-input transformation to a windowed signal.
+     *
+     * The windowed samples are written straight into the output array,
+     * where the half-length transform runs.
+     *
+     * @param x input signal
+     * @param window window coefficients
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void AquilaFft::rfftWindowed(const SampleType x[], const SampleType window[],
+                                 ComplexType spectrum[])
+    {
+        multiplyWindow(x, window, reinterpret_cast<SampleType*>(spectrum), N);
+        transformReal(spectrum);
     }
 
     /**
-     * Returns a table of Wi (twiddle factors) stored in cache.
+     * Transforms N real samples stored as N/2 complex values into N/2+1
+     * bins, in place.
      *
-     * @param numStages the FFT stages count
-     * @return pointer to an array of pointers to arrays of complex numbers
+     * @param spectrum N real samples on input, N/2+1 bins on output
      */
-    ComplexType** AquilaFft::getCachedFftWi(unsigned int numStages)
+    void AquilaFft::transformReal(ComplexType spectrum[])
     {
-        fftWiCacheKeyType key = numStages;
-        // cache hit, return immediately
-        if (fftWiCache.find(key) != fftWiCache.end())
-        {
-            return fftWiCache[key];
-        }
+        const std::size_t M = N / 2;
+        transform<false>(spectrum, M, m_tables->halfSwaps);
+
+        // W^k = exp(-2 pi i k / N) are the twiddles of the last stage
+        const SampleType* w = reinterpret_cast<const SampleType*>(&m_tables->twiddles[M - 1]);
+        SampleType* a = reinterpret_cast<SampleType*>(spectrum);
+        splitRealSpectrum(a, a + 1, 2, w, M, a);
+    }
 
-        // nothing in cache, calculate twiddle factors
-        ComplexType** Wi = new ComplexType*[numStages + 1];
-        for (unsigned int k = 1; k <= numStages; ++k)
+    /**
+     * Applies the inverse transform to a half spectrum.
+     *
+     * Reverses the split done by rfft() into the output array, viewed as
+     * N/2 complex values, and transforms it in place.
+     *
+     * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+     * @param x output signal
+     */
+    void AquilaFft::irfft(const ComplexType spectrum[], SampleType x[])
+    {
+        const std::size_t M = N / 2;
+        ComplexType* z = reinterpret_cast<ComplexType*>(x);
+
+        // the factors of 1/2 are folded into the final scaling
+        const SampleType* w = reinterpret_cast<const SampleType*>(&m_tables->twiddles[M - 1]);
+        mergeRealSpectrum(reinterpret_cast<const SampleType*>(spectrum), w, M, nullptr,
+                          x, x + 1, 2);
+
+        transform<true>(z, M, m_tables->halfSwaps);
+        const SampleType scale = SampleType(1) / N;
+        for (std::size_t i = 0; i < N; ++i)
         {
-            // L = 2^k - DFT block length and offset
-            // M = 2^(k-1) - butterflies per block, butterfly width
-            // W - Fourier base multiplying factor
-            unsigned int L = 1 << k;
-            unsigned int M = 1 << (k - 1);
-            ComplexType W = exp((-j) * 2.0 * M_PI / static_cast<double>(L));
-            Wi[k] = new ComplexType[M + 1];
-            Wi[k][0] = ComplexType(1.0);
-            for (unsigned int p = 1; p <= M; ++p)
-            {
-                Wi[k][p] = Wi[k][p - 1] * W;
-            }
+            x[i] *= scale;
         }
+    }
 
-        // store in cache and return
-        fftWiCache[key] = Wi;
+    /**
+     * Applies the transformation in place.
+     *
+     * @param data complex signal on input, its spectrum on output
+     */
+    void AquilaFft::fftInPlace(ComplexType data[])
+    {
+        transform<false>(data, N, m_tables->swaps);
+    }
 
-        return Wi;
+    /**
+     * Applies the inverse transformation in place.
+     *
+     * @param data spectrum on input, complex signal on output
+     */
+    void AquilaFft::ifftInPlace(ComplexType data[])
+    {
+        transform<true>(data, N, m_tables->swaps);
+        const SampleType scale = SampleType(1) / N;
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            data[k] *= scale;
+        }
     }
 
     /**
-     * Clears the twiddle factor cache.
+     * Bit-reverses the data and runs the butterfly stages over it.
+     *
+     * The inverse transform uses conjugated twiddle factors and does not
+     * apply the 1/N scaling. The butterflies are written out on real and
+     * imaginary parts, which avoids the overflow and NaN handling of
+     * std::complex multiplication.
+     *
+     * @param data array of length complex values
+     * @param length transform length, N or N/2
+     * @param swaps bit reversal of that length
      */
-    void AquilaFft::clearFftWiCache()
+    template <bool Inverse>
+    void AquilaFft::transform(ComplexType data[], std::size_t length,
+                              const std::vector<std::pair<std::uint32_t, std::uint32_t>>& swaps) const
     {
-        for (auto it = fftWiCache.begin(); it != fftWiCache.end(); it++)
+        for (std::size_t i = 0; i < swaps.size(); ++i)
+        {
+            std::swap(data[swaps[i].first], data[swaps[i].second]);
+        }
+        if (length < 2)
+        {
+            return;
+        }
+
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        // the first stage needs no multiplications (W^0 = 1)
+        for (std::size_t j = 0; j < 2 * length; j += 4)
         {
-            ComplexType** c = it->second;
-            unsigned int numStages = it->first;
-            for (unsigned int i = 1; i <= numStages; ++i)
+            const SampleType r0 = a[j], i0 = a[j + 1];
+            const SampleType r1 = a[j + 2], i1 = a[j + 3];
+            a[j] = r0 + r1;
+            a[j + 1] = i0 + i1;
+            a[j + 2] = r0 - r1;
+            a[j + 3] = i0 - i1;
+        }
+
+        // M - butterflies per block (half of the block length)
+        for (std::size_t M = 2; M < length; M *= 2)
+        {
+            const SampleType* w = reinterpret_cast<const SampleType*>(&m_tables->twiddles[M - 1]);
+            for (std::size_t j = 0; j < length; j += 2 * M)
             {
-                delete [] c[i];
+                SampleType* AQUILA_RESTRICT lo = a + 2 * j;
+                SampleType* AQUILA_RESTRICT hi = lo + 2 * M;
+                for (std::size_t p = 0; p < M; ++p)
+                {
+                    const SampleType wr = w[2 * p];
+                    const SampleType wi = Inverse ? -w[2 * p + 1] : w[2 * p + 1];
+                    const SampleType tr = wr * hi[2 * p] - wi * hi[2 * p + 1];
+                    const SampleType ti = wr * hi[2 * p + 1] + wi * hi[2 * p];
+                    hi[2 * p] = lo[2 * p] - tr;
+                    hi[2 * p + 1] = lo[2 * p + 1] - ti;
+                    lo[2 * p] += tr;
+                    lo[2 * p + 1] += ti;
+                }
             }
-
-            delete [] c;
         }
     }
 }
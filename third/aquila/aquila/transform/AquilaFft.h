@@ -19,8 +19,11 @@
 #define AQUILAFFT_H
 
 #include "Fft.h"
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace Aquila
 {
@@ -31,57 +34,81 @@ namespace Aquila
 
     /**
      * A custom implementation of FFT radix-2 algorithm.
+     *
+     * Pure C++, with no dependency on Ooura's package, so it can stand in
+     * for OouraFft wherever the C code is not wanted. The twiddle factors
+     * of all stages are stored in one contiguous array, stage after stage,
+     * and the bit reversal permutation is a precomputed list of swaps;
+     * both are built once per length and shared (see PlanCache). The
+     * butterflies run in place over the data with 0-based indices, the
+     * innermost loop walking consecutive values and twiddles.
+     *
+     * Real transforms pack the N real samples into N/2 complex values and
+     * run a transform of half the length, directly in the output array.
      */
     class AQUILA_EXPORT AquilaFft : public Fft
     {
     public:
-        /**
-         * Initializes the transform for a given input length.
-         *
-         * @param length input signal size (usually a power of 2)
-         */
-        AquilaFft(std::size_t length):
-            Fft(length), fftWiCache()
-        {
-        }
+        AquilaFft(std::size_t length);
 
-        /**
-         * Destroys the transform object.
-         *
-         * @todo clear the cache somewhere else, not here!
-         */
-        ~AquilaFft()
-        {
-            clearFftWiCache();
-        }
+        using Fft::fft;
+        using Fft::ifft;
+        using Fft::rfft;
+        using Fft::irfft;
 
-        virtual SpectrumType fft(const SampleType x[]);
-        virtual void ifft(SpectrumType spectrum, double x[]);
+        virtual void fft(const SampleType x[], ComplexType spectrum[]);
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]);
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]);
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]);
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]);
+        virtual void fftInPlace(ComplexType data[]);
+        virtual void ifftInPlace(ComplexType data[]);
 
     private:
         /**
-         * Complex unit (0.0 + 1.0j).
+         * Twiddles and permutations of one transform length.
          */
-        static const ComplexType j;
+        struct Tables
+        {
+            Tables(std::size_t length);
 
-        /**
-         * Type of the twiddle factor cache key.
-         */
-        typedef unsigned int fftWiCacheKeyType;
+            /**
+             * Twiddle factors of all stages.
+             *
+             * The stage combining blocks of M values into blocks of 2M
+             * uses W^p = exp(-2 pi i p / 2M) for p = 0..M-1, stored from
+             * index M-1. The first N/2-1 values are therefore also the
+             * table of the half-length transform, and the last stage
+             * holds the factors which split a real spectrum.
+             */
+            std::vector<ComplexType> twiddles;
+
+            /**
+             * Index pairs exchanged by the bit reversal of N values.
+             */
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> swaps;
+
+            /**
+             * Index pairs exchanged by the bit reversal of N/2 values.
+             */
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> halfSwaps;
+        };
+
+        template <bool Inverse>
+        void transform(ComplexType data[], std::size_t length,
+                       const std::vector<std::pair<std::uint32_t, std::uint32_t>>& swaps) const;
+        void transformReal(ComplexType spectrum[]);
 
         /**
-         * Type of the twiddle factor cache.
+         * Shared tables of this length.
          */
-        typedef std::map<fftWiCacheKeyType, ComplexType**> fftWiCacheType;
+        std::shared_ptr<const Tables> m_tables;
 
         /**
-         * Twiddle factor cache - implemented as a map.
+         * Half spectrum scratch used by ifft().
          */
-        fftWiCacheType fftWiCache;
-
-        ComplexType** getCachedFftWi(unsigned int numStages);
-
-        void clearFftWiCache();
+        SpectrumType m_work;
     };
 }
 
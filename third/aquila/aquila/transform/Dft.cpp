@@ -29,49 +29,154 @@ namespace Aquila
     /**
      * Complex unit.
      */
-    const ComplexType Dft::j(0, 1);
+    const Dft::AccumulatorType Dft::j(0, 1);
 
     /**
      * Applies the transformation to the signal.
      *
      * @param x input signal
-     * @return calculated spectrum
+     * @param spectrum output spectrum (N bins)
      */
-    SpectrumType Dft::fft(const SampleType x[])
+    void Dft::fft(const SampleType x[], ComplexType spectrum[])
     {
-        SpectrumType spectrum(N);
-        ComplexType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
 
         for (unsigned int k = 0; k < N; ++k)
         {
-            ComplexType sum(0, 0);
+            AccumulatorType sum(0, 0);
             for (unsigned int n = 0; n < N; ++n)
             {
-                sum += x[n] * std::pow(WN, n * k);
+                sum += static_cast<double>(x[n]) * std::pow(WN, n * k);
             }
-            spectrum[k] = sum;
+            spectrum[k] = ComplexType(sum);
         }
-
-        return spectrum;
     }
 
     /**
      * Applies the inverse transform to the spectrum.
      *
-     * @param spectrum input spectrum
+     * @param spectrum input spectrum (N bins)
+     * @param x output signal
+     */
+    void Dft::ifft(const ComplexType spectrum[], SampleType x[])
+    {
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+        for (unsigned int k = 0; k < N; ++k)
+        {
+            AccumulatorType sum(0, 0);
+            for (unsigned int n = 0; n < N; ++n)
+            {
+                sum += AccumulatorType(spectrum[n]) * std::pow(WN, -static_cast<int>(n * k));
+            }
+            x[k] = sum.real() / static_cast<double>(N);
+        }
+    }
+
+    /**
+     * Applies the transformation to a real signal.
+     *
+     * Only the N/2+1 unique bins are calculated.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void Dft::rfft(const SampleType x[], ComplexType spectrum[])
+    {
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+
+        for (unsigned int k = 0; k <= N / 2; ++k)
+        {
+            AccumulatorType sum(0, 0);
+            for (unsigned int n = 0; n < N; ++n)
+            {
+                sum += static_cast<double>(x[n]) * std::pow(WN, n * k);
+            }
+            spectrum[k] = ComplexType(sum);
+        }
+    }
+
+    /**
+     * Applies the real-input transformation to a windowed signal.
+     *
+     * @param x input signal
+     * @param window window coefficients
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void Dft::rfftWindowed(const SampleType x[], const SampleType window[],
+                           ComplexType spectrum[])
+    {
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+
+        for (unsigned int k = 0; k <= N / 2; ++k)
+        {
+            AccumulatorType sum(0, 0);
+            for (unsigned int n = 0; n < N; ++n)
+            {
+                sum += static_cast<double>(x[n] * window[n]) * std::pow(WN, n * k);
+            }
+            spectrum[k] = ComplexType(sum);
+        }
+    }
+
+    /**
+     * Applies the inverse transform to a half spectrum.
+     *
+     * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
      * @param x output signal
      */
-    void Dft::ifft(SpectrumType spectrum, double x[])
+    void Dft::irfft(const ComplexType spectrum[], SampleType x[])
+    {
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+        for (unsigned int k = 0; k < N; ++k)
+        {
+            AccumulatorType sum(0, 0);
+            for (unsigned int n = 0; n < N; ++n)
+            {
+                AccumulatorType value = (n <= N / 2) ? spectrum[n] : std::conj(spectrum[N - n]);
+                sum += value * std::pow(WN, -static_cast<int>(n * k));
+            }
+            x[k] = sum.real() / static_cast<double>(N);
+        }
+    }
+
+    /**
+     * Applies the transformation in place.
+     *
+     * @param data complex signal on input, its spectrum on output
+     */
+    void Dft::fftInPlace(ComplexType data[])
+    {
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+
+        for (unsigned int k = 0; k < N; ++k)
+        {
+            AccumulatorType sum(0, 0);
+            for (unsigned int n = 0; n < N; ++n)
+            {
+                sum += AccumulatorType(data[n]) * std::pow(WN, n * k);
+            }
+            work[k] = ComplexType(sum);
+        }
+        std::copy(std::begin(work), std::end(work), data);
+    }
+
+    /**
+     * Applies the inverse transformation in place.
+     *
+     * @param data spectrum on input, complex signal on output
+     */
+    void Dft::ifftInPlace(ComplexType data[])
     {
-        ComplexType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
+        const AccumulatorType WN = std::exp((-j) * 2.0 * M_PI / static_cast<double>(N));
         for (unsigned int k = 0; k < N; ++k)
         {
-            ComplexType sum(0, 0);
+            AccumulatorType sum(0, 0);
             for (unsigned int n = 0; n < N; ++n)
             {
-                sum += spectrum[n] * std::pow(WN, -static_cast<int>(n * k));
+                sum += AccumulatorType(data[n]) * std::pow(WN, -static_cast<int>(n * k));
             }
-            x[k] = std::abs(sum) / static_cast<double>(N);
+            work[k] = ComplexType(sum / static_cast<double>(N));
         }
+        std::copy(std::begin(work), std::end(work), data);
     }
 }
@@ -38,7 +38,7 @@ namespace Aquila
          * @param length input signal size
          */
         Dft(std::size_t length):
-            Fft(length)
+            Fft(length), work(length)
         {
         }
 
@@ -49,14 +49,35 @@ namespace Aquila
         {
         }
 
-        virtual SpectrumType fft(const SampleType x[]);
-        virtual void ifft(SpectrumType spectrum, double x[]);
+        using Fft::fft;
+        using Fft::ifft;
+        using Fft::rfft;
+        using Fft::irfft;
+
+        virtual void fft(const SampleType x[], ComplexType spectrum[]);
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]);
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]);
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]);
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]);
+        virtual void fftInPlace(ComplexType data[]);
+        virtual void ifftInPlace(ComplexType data[]);
 
     private:
+        /**
+         * The reference transform always sums in double precision.
+         */
+        typedef std::complex<double> AccumulatorType;
+
         /**
          * Complex unit (0.0 + 1.0j).
          */
-        static const ComplexType j;
+        static const AccumulatorType j;
+
+        /**
+         * Scratch area for the in-place transforms.
+         */
+        SpectrumType work;
     };
 }
 
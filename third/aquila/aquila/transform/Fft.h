@@ -38,6 +38,16 @@ namespace Aquila
      * for the base FFT interface. A derived class should calculate the
      * plan once - in the constructor (based on FFT length). Later calls
      * to fft() / ifft() should reuse the already created plan/cache.
+     *
+     * Each transform comes in two flavours. The ones taking and returning
+     * SpectrumType are convenience wrappers which allocate the result.
+     * The virtual overloads working on caller-provided buffers (and the
+     * in-place variants) are the primitives every implementation provides;
+     * they must not touch the heap, so they can be used from a real-time
+     * thread. Any scratch space needed is allocated with the plan.
+     *
+     * Derived classes overriding the primitives should bring the wrappers
+     * into scope with "using Fft::fft;" etc., as usual in C++.
      */
     class AQUILA_EXPORT Fft
     {
@@ -64,10 +74,17 @@ namespace Aquila
         /**
          * Applies the forward FFT transform to the signal.
          *
+         * This is a convenience wrapper which allocates the result.
+         *
          * @param x input signal
          * @return calculated spectrum
          */
-        virtual SpectrumType fft(const SampleType x[]) = 0;
+        SpectrumType fft(const SampleType x[])
+        {
+            SpectrumType spectrum(N);
+            fft(x, &spectrum[0]);
+            return spectrum;
+        }
 
         /**
          * Applies the inverse FFT transform to the spectrum.
@@ -75,9 +92,167 @@ namespace Aquila
          * @param spectrum input spectrum
          * @param x output signal
          */
-        virtual void ifft(SpectrumType spectrum, double x[]) = 0;
+        void ifft(const SpectrumType& spectrum, SampleType x[])
+        {
+            ifft(&spectrum[0], x);
+        }
+
+        /**
+         * Applies the forward FFT transform to a real signal.
+         *
+         * The spectrum of a real signal is conjugate-symmetric, so only
+         * the N/2+1 bins from DC to Nyquist are unique and returned.
+         *
+         * @param x input signal
+         * @return first N/2+1 bins of the spectrum
+         */
+        SpectrumType rfft(const SampleType x[])
+        {
+            SpectrumType spectrum(N / 2 + 1);
+            rfft(x, &spectrum[0]);
+            return spectrum;
+        }
+
+        /**
+         * Applies the inverse FFT transform to a half spectrum.
+         *
+         * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+         * @param x output signal
+         */
+        void irfft(const SpectrumType& spectrum, SampleType x[])
+        {
+            irfft(&spectrum[0], x);
+        }
+
+        /**
+         * Applies the forward FFT transform into a caller-provided buffer.
+         *
+         * Implementations must not allocate memory here.
+         *
+         * @param x input signal (N samples)
+         * @param spectrum output spectrum (N bins)
+         */
+        virtual void fft(const SampleType x[], ComplexType spectrum[]) = 0;
+
+        /**
+         * Applies the inverse FFT transform into a caller-provided buffer.
+         *
+         * Implementations must not allocate memory here.
+         *
+         * @param spectrum input spectrum (N bins)
+         * @param x output signal (N samples)
+         */
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]) = 0;
+
+        /**
+         * Applies the forward FFT transform to a real signal, writing
+         * the N/2+1 unique bins into a caller-provided buffer.
+         *
+         * Implementations must not allocate memory here.
+         *
+         * @param x input signal (N samples)
+         * @param spectrum output spectrum (N/2+1 bins)
+         */
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]) = 0;
+
+        /**
+         * Applies the forward FFT transform to a windowed real signal.
+         *
+         * Same as multiplying x by the window and calling rfft(), but the
+         * multiplication is done while the input is copied into the
+         * transform's own working layout, so no separate pass over the
+         * data and no scratch buffer are needed.
+         *
+         * Implementations must not allocate memory here.
+         *
+         * @param x input signal (N samples)
+         * @param window window coefficients (N values)
+         * @param spectrum output spectrum (N/2+1 bins)
+         */
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]) = 0;
+
+        /**
+         * Applies the inverse FFT transform to a half spectrum, writing
+         * the signal into a caller-provided buffer.
+         *
+         * Implementations must not allocate memory here.
+         *
+         * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+         * @param x output signal (N samples)
+         */
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]) = 0;
+
+        /**
+         * Applies the forward FFT transform in place.
+         *
+         * @param data complex signal on input, its spectrum on output
+         */
+        virtual void fftInPlace(ComplexType data[]) = 0;
+
+        /**
+         * Applies the inverse FFT transform in place, including
+         * the 1/N scaling.
+         *
+         * @param data spectrum on input, complex signal on output
+         */
+        virtual void ifftInPlace(ComplexType data[]) = 0;
+
+        /**
+         * Applies the forward FFT transform to a batch of real signals.
+         *
+         * The spectra are written one after another, N/2+1 bins each,
+         * into a single caller-provided array. The default implementation
+         * calls rfft() for every signal; implementations may override it
+         * to transform several signals at once.
+         *
+         * @param x pointers to count input signals (N samples each)
+         * @param count number of signals
+         * @param spectra output spectra (count * (N/2+1) bins)
+         */
+        virtual void rfftBatch(const SampleType* const x[], std::size_t count,
+                               ComplexType spectra[])
+        {
+            const std::size_t bins = N / 2 + 1;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                rfft(x[i], spectra + i * bins);
+            }
+        }
+
+        /**
+         * Returns the transform length.
+         *
+         * @return signal and spectrum length
+         */
+        std::size_t getLength() const
+        {
+            return N;
+        }
 
     protected:
+        /**
+         * Multiplies a signal by a window, element by element.
+         *
+         * The arrays must not overlap, which lets the compiler vectorize
+         * the loop.
+         *
+         * @param x input signal
+         * @param window window coefficients
+         * @param out output array
+         * @param length number of samples
+         */
+        static void multiplyWindow(const SampleType* AQUILA_RESTRICT x,
+                                   const SampleType* AQUILA_RESTRICT window,
+                                   SampleType* AQUILA_RESTRICT out,
+                                   std::size_t length)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                out[i] = x[i] * window[i];
+            }
+        }
+
         /**
          * Signal and spectrum length.
          */
@@ -16,10 +16,93 @@
  */
 
 #include "FftFactory.h"
+#include "AquilaFft.h"
 #include "OouraFft.h"
+#include "FixedFft.h"
+#include "SimdFft.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace Aquila
 {
+    namespace
+    {
+        /**
+         * Backend used by getFft() without an explicit choice.
+         */
+        std::atomic<int> defaultBackend(FftFactory::Automatic);
+
+        /**
+         * Tuning results, by length.
+         */
+        std::map<std::size_t, FftFactory::BackendType> tunedBackends;
+        std::mutex tunedBackendsMutex;
+
+        bool isPowerOf2(std::size_t length)
+        {
+            return length >= 4 && (length & (length - 1)) == 0;
+        }
+
+        std::shared_ptr<Fft> createFixedFft(std::size_t length)
+        {
+            switch (length)
+            {
+            case 256:
+                return std::shared_ptr<Fft>(new FixedFft<256>());
+            case 512:
+                return std::shared_ptr<Fft>(new FixedFft<512>());
+            case 1024:
+                return std::shared_ptr<Fft>(new FixedFft<1024>());
+            case 2048:
+                return std::shared_ptr<Fft>(new FixedFft<2048>());
+            case 4096:
+                return std::shared_ptr<Fft>(new FixedFft<4096>());
+            default:
+                return std::shared_ptr<Fft>();
+            }
+        }
+
+        /**
+         * Best time of a few rounds of real transforms, in seconds per
+         * transform.
+         */
+        double timeFft(Fft& fft, std::size_t length)
+        {
+            std::vector<SampleType> signal(length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                signal[i] = static_cast<SampleType>(std::sin(0.1 * i) + 0.25 * std::cos(0.37 * i));
+            }
+            SpectrumType spectrum(length / 2 + 1);
+            // warm up caches and lazily built tables
+            fft.rfft(&signal[0], &spectrum[0]);
+
+            const std::size_t repetitions = std::max<std::size_t>(1, 65536 / length);
+            double best = 0.0;
+            for (int round = 0; round < 5; ++round)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                for (std::size_t i = 0; i < repetitions; ++i)
+                {
+                    fft.rfft(&signal[0], &spectrum[0]);
+                }
+                const std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                const double perTransform = elapsed.count() / repetitions;
+                if (round == 0 || perTransform < best)
+                {
+                    best = perTransform;
+                }
+            }
+            return best;
+        }
+    }
+
     /**
      * Returns "the best possible" FFT object.
      *
@@ -29,14 +112,125 @@ namespace Aquila
      * the choice of FFT implementation - hidden from the caller who gets
      * only a pointer to the base abstract Fft class.
      *
-     * As of now, the fastest implementation in Aquila is using Ooura's
-     * mathematical packages, so this one is always returned.
+     * The choice is made by the process-wide backend (see setBackend()).
+     *
+     * Every call returns a new object, but objects of the same backend and
+     * length share one set of immutable tables (see PlanCache); only
+     * their scratch buffers are their own. Give each thread its own
+     * object rather than sharing one.
      *
      * @param length FFT length (number of samples)
      * @return the FFT object (wrapped in a shared_ptr)
      */
     std::shared_ptr<Fft> FftFactory::getFft(std::size_t length)
     {
+        return getFft(length, getBackend());
+    }
+
+    /**
+     * Returns an FFT object of the chosen backend.
+     *
+     * A backend which cannot handle the length falls back to the
+     * automatic choice.
+     *
+     * @param length FFT length (number of samples)
+     * @param backend implementation selection
+     * @return the FFT object (wrapped in a shared_ptr)
+     */
+    std::shared_ptr<Fft> FftFactory::getFft(std::size_t length, BackendType backend)
+    {
+        if (backend == Tuned)
+        {
+            backend = tune(length);
+        }
+        if (backend == Simd && isPowerOf2(length))
+        {
+            return std::shared_ptr<Fft>(new SimdFft(length));
+        }
+        if (backend == Portable && isPowerOf2(length))
+        {
+            return std::shared_ptr<Fft>(new AquilaFft(length));
+        }
+        if (backend == Fixed || backend == Automatic)
+        {
+            std::shared_ptr<Fft> fixed = createFixedFft(length);
+            if (fixed)
+            {
+                return fixed;
+            }
+        }
         return std::shared_ptr<Fft>(new OouraFft(length));
     }
+
+    /**
+     * Sets the backend used by getFft() without an explicit choice.
+     *
+     * @param backend implementation selection
+     */
+    void FftFactory::setBackend(BackendType backend)
+    {
+        defaultBackend = backend;
+    }
+
+    /**
+     * Returns the backend used by getFft() without an explicit choice.
+     *
+     * @return implementation selection
+     */
+    FftFactory::BackendType FftFactory::getBackend()
+    {
+        return static_cast<BackendType>(defaultBackend.load());
+    }
+
+    /**
+     * Finds the fastest backend for a transform length.
+     *
+     * Each backend able to handle the length is timed on real transforms
+     * of a fixed test signal. The first call for a length takes a few
+     * milliseconds, the result is remembered for the rest of the process.
+     * Meant to be called at startup, not in a real-time context.
+     *
+     * @param length FFT length (number of samples)
+     * @return Ooura, Fixed, Simd or Portable
+     */
+    FftFactory::BackendType FftFactory::tune(std::size_t length)
+    {
+        std::lock_guard<std::mutex> lock(tunedBackendsMutex);
+        std::map<std::size_t, BackendType>::const_iterator it = tunedBackends.find(length);
+        if (it != tunedBackends.end())
+        {
+            return it->second;
+        }
+
+        BackendType fastest = Ooura;
+        if (isPowerOf2(length))
+        {
+            OouraFft ooura(length);
+            double best = timeFft(ooura, length);
+            std::shared_ptr<Fft> fixed = createFixedFft(length);
+            if (fixed)
+            {
+                const double time = timeFft(*fixed, length);
+                if (time < best)
+                {
+                    best = time;
+                    fastest = Fixed;
+                }
+            }
+            SimdFft simd(length);
+            const double simdTime = timeFft(simd, length);
+            if (simdTime < best)
+            {
+                best = simdTime;
+                fastest = Simd;
+            }
+            AquilaFft portable(length);
+            if (timeFft(portable, length) < best)
+            {
+                fastest = Portable;
+            }
+        }
+        tunedBackends[length] = fastest;
+        return fastest;
+    }
 }
@@ -27,11 +27,34 @@ namespace Aquila
 {
     /**
      * A factory class to manage the creation of FFT calculation objects.
+     *
+     * The implementation is chosen by a backend setting, either passed to
+     * getFft() or set once for the whole process with setBackend():
+     *
+     * - Automatic - FixedFft for the lengths it is compiled for, OouraFft
+     *   for everything else (the default)
+     * - Ooura - always OouraFft
+     * - Fixed - FixedFft where possible, otherwise as Automatic
+     * - Simd - SimdFft for powers of 2, otherwise OouraFft
+     * - Portable - AquilaFft for powers of 2, otherwise OouraFft
+     * - Tuned - the fastest of the above for the requested length, found
+     *   by timing each of them once per length (see tune())
      */
     class AQUILA_EXPORT FftFactory
     {
     public:
+        /**
+         * FFT implementation selection.
+         */
+        enum BackendType {Automatic, Ooura, Fixed, Simd, Portable, Tuned};
+
         static std::shared_ptr<Fft> getFft(std::size_t length);
+        static std::shared_ptr<Fft> getFft(std::size_t length, BackendType backend);
+
+        static void setBackend(BackendType backend);
+        static BackendType getBackend();
+
+        static BackendType tune(std::size_t length);
     };
 }
 
@@ -0,0 +1,469 @@
+/**
+ * @file FixedFft.cpp
+ *
+ * FFT specialized for a transform length known at compile time.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "FixedFft.h"
+#include "RealSplit.h"
+#include "../Exceptions.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aquila
+{
+    static_assert(
+        sizeof(ComplexType[2]) == sizeof(SampleType[4]),
+        "complex<T> has the same memory layout as two consecutive T values"
+    );
+
+    namespace
+    {
+        /**
+         * Base 2 logarithm of a power of 2, at compile time.
+         */
+        template <std::size_t N>
+        struct Log2
+        {
+            static const std::size_t value = 1 + Log2<N / 2>::value;
+        };
+
+        template <>
+        struct Log2<1>
+        {
+            static const std::size_t value = 0;
+        };
+
+        /**
+         * One radix-4 pass combining sub-transforms of length L, followed
+         * by all the remaining passes.
+         *
+         * Each pass is two fused radix-2 stages, so the data is read and
+         * written once per two stages. The recursion unrolls the pass sequence at compile
+         * time, so every loop has a constant trip count and every twiddle
+         * offset is a constant. Real and imaginary parts are kept in
+         * separate arrays, which lets the compiler vectorize the butterfly
+         * loop without shuffling.
+         *
+         * @param re real parts of M values
+         * @param im imaginary parts of M values
+         * @param w twiddles of this pass: Re W^k, Im W^k, Re W^2k, Im W^2k
+         *          for k = 0..L-1, each as a run of L values
+         */
+        template <std::size_t M, std::size_t L, bool Inverse, bool Last = (4 * L > M)>
+        struct Radix4Pass
+        {
+            /**
+             * Butterflies of one block, the four quarters never overlap.
+             */
+            static void butterflies(SampleType* AQUILA_RESTRICT r0, SampleType* AQUILA_RESTRICT r1,
+                                    SampleType* AQUILA_RESTRICT r2, SampleType* AQUILA_RESTRICT r3,
+                                    SampleType* AQUILA_RESTRICT i0, SampleType* AQUILA_RESTRICT i1,
+                                    SampleType* AQUILA_RESTRICT i2, SampleType* AQUILA_RESTRICT i3,
+                                    const SampleType* AQUILA_RESTRICT w)
+            {
+                // multiplication by -i (forward) or +i (inverse) is a swap
+                // of the components with one sign change
+                const SampleType rot = Inverse ? 1 : -1;
+                const SampleType conj = Inverse ? -1 : 1;
+                const SampleType* w1r = w;
+                const SampleType* w1i = w + L;
+                const SampleType* w2r = w + 2 * L;
+                const SampleType* w2i = w + 3 * L;
+                for (std::size_t k = 0; k < L; ++k)
+                {
+                    const SampleType c1r = w1r[k], c1i = conj * w1i[k];
+                    const SampleType c2r = w2r[k], c2i = conj * w2i[k];
+                    // first stage: pairs of length L into length 2L
+                    const SampleType br = c2r * r1[k] - c2i * i1[k];
+                    const SampleType bi = c2r * i1[k] + c2i * r1[k];
+                    const SampleType dr = c2r * r3[k] - c2i * i3[k];
+                    const SampleType di = c2r * i3[k] + c2i * r3[k];
+                    const SampleType e0r = r0[k] + br, e0i = i0[k] + bi;
+                    const SampleType e1r = r0[k] - br, e1i = i0[k] - bi;
+                    const SampleType o0r = r2[k] + dr, o0i = i2[k] + di;
+                    const SampleType o1r = r2[k] - dr, o1i = i2[k] - di;
+                    // second stage, W^(k+L) = -i W^k (forward)
+                    const SampleType t0r = c1r * o0r - c1i * o0i;
+                    const SampleType t0i = c1r * o0i + c1i * o0r;
+                    const SampleType t1r = c1r * o1r - c1i * o1i;
+                    const SampleType t1i = c1r * o1i + c1i * o1r;
+                    r0[k] = e0r + t0r;
+                    i0[k] = e0i + t0i;
+                    r2[k] = e0r - t0r;
+                    i2[k] = e0i - t0i;
+                    r1[k] = e1r - rot * t1i;
+                    i1[k] = e1i + rot * t1r;
+                    r3[k] = e1r + rot * t1i;
+                    i3[k] = e1i - rot * t1r;
+                }
+            }
+
+            static void run(SampleType re[], SampleType im[], const SampleType w[])
+            {
+                for (std::size_t j = 0; j < M; j += 4 * L)
+                {
+                    butterflies(re + j, re + j + L, re + j + 2 * L, re + j + 3 * L,
+                                im + j, im + j + L, im + j + 2 * L, im + j + 3 * L, w);
+                }
+                Radix4Pass<M, 4 * L, Inverse>::run(re, im, w + 4 * L);
+            }
+        };
+
+        template <std::size_t M, std::size_t L, bool Inverse>
+        struct Radix4Pass<M, L, Inverse, true>
+        {
+            static void run(SampleType[], SampleType[], const SampleType[])
+            {
+            }
+        };
+
+        /**
+         * Complex FFT of M points on split real and imaginary arrays.
+         *
+         * The input is loaded in bit reversed order. A twiddle-free first
+         * pass (radix-2 when log2(M) is odd, radix-4 otherwise) is then
+         * followed by radix-4 passes.
+         */
+        template <std::size_t M>
+        class ComplexKernel
+        {
+        public:
+            static const std::size_t STAGES = Log2<M>::value;
+
+            /**
+             * Sub-transform length after the twiddle-free first pass.
+             */
+            static const std::size_t FIRST_LENGTH = (STAGES % 2) ? 2 : 4;
+
+            /**
+             * Permutation and twiddles, built once per length.
+             */
+            struct Tables
+            {
+                /**
+                 * Bit reversed index of each position.
+                 */
+                std::vector<std::uint32_t> reversed;
+
+                /**
+                 * Twiddles of all radix-4 passes, in order.
+                 */
+                std::vector<SampleType> twiddles;
+            };
+
+            static const Tables& tables()
+            {
+                static const Tables instance = build();
+                return instance;
+            }
+
+            /**
+             * Splits interleaved complex values into the work arrays,
+             * in bit reversed order.
+             *
+             * @param in M complex values as 2*M interleaved reals
+             * @param re real parts output
+             * @param im imaginary parts output
+             */
+            static void load(const SampleType in[], SampleType re[], SampleType im[])
+            {
+                const std::uint32_t* reversed = &tables().reversed[0];
+                for (std::size_t i = 0; i < M; ++i)
+                {
+                    re[i] = in[2 * reversed[i]];
+                    im[i] = in[2 * reversed[i] + 1];
+                }
+            }
+
+            static void loadWindowed(const SampleType in[], const SampleType window[],
+                                     SampleType re[], SampleType im[])
+            {
+                const std::uint32_t* reversed = &tables().reversed[0];
+                for (std::size_t i = 0; i < M; ++i)
+                {
+                    const std::size_t n = 2 * reversed[i];
+                    re[i] = in[n] * window[n];
+                    im[i] = in[n + 1] * window[n + 1];
+                }
+            }
+
+            template <bool Inverse>
+            static void transform(SampleType re[], SampleType im[]);
+
+        private:
+            static Tables build();
+        };
+
+        template <std::size_t M>
+        typename ComplexKernel<M>::Tables ComplexKernel<M>::build()
+        {
+            Tables t;
+            t.reversed = bitReversedIndices(M);
+            t.twiddles = radix4Twiddles(M, FIRST_LENGTH);
+            return t;
+        }
+
+        /**
+         * Runs the transform on loaded data, in place and without scaling.
+         *
+         * The inverse uses conjugated twiddles.
+         *
+         * @param re real parts of M values in bit reversed order
+         * @param im imaginary parts of M values in bit reversed order
+         */
+        template <std::size_t M>
+        template <bool Inverse>
+        void ComplexKernel<M>::transform(SampleType re[], SampleType im[])
+        {
+            const SampleType rot = Inverse ? 1 : -1;
+            if (FIRST_LENGTH == 2)
+            {
+                for (std::size_t j = 0; j < M; j += 2)
+                {
+                    const SampleType r0 = re[j], i0 = im[j];
+                    const SampleType r1 = re[j + 1], i1 = im[j + 1];
+                    re[j] = r0 + r1;
+                    im[j] = i0 + i1;
+                    re[j + 1] = r0 - r1;
+                    im[j + 1] = i0 - i1;
+                }
+            }
+            else
+            {
+                // blocks hold the sub-transforms of x[4n], x[4n+2],
+                // x[4n+1], x[4n+3], which is the binary bit reversed order
+                for (std::size_t j = 0; j < M; j += 4)
+                {
+                    const SampleType er0 = re[j] + re[j + 1], ei0 = im[j] + im[j + 1];
+                    const SampleType er1 = re[j] - re[j + 1], ei1 = im[j] - im[j + 1];
+                    const SampleType or0 = re[j + 2] + re[j + 3], oi0 = im[j + 2] + im[j + 3];
+                    const SampleType or1 = re[j + 2] - re[j + 3], oi1 = im[j + 2] - im[j + 3];
+                    re[j] = er0 + or0;
+                    im[j] = ei0 + oi0;
+                    re[j + 2] = er0 - or0;
+                    im[j + 2] = ei0 - oi0;
+                    re[j + 1] = er1 - rot * oi1;
+                    im[j + 1] = ei1 + rot * or1;
+                    re[j + 3] = er1 + rot * oi1;
+                    im[j + 3] = ei1 - rot * or1;
+                }
+            }
+            Radix4Pass<M, FIRST_LENGTH, Inverse>::run(re, im, &tables().twiddles[0]);
+        }
+
+        /**
+         * Twiddles W^k of an N-point transform for k = 0..N/4, used to
+         * split a half-length complex spectrum into a real one.
+         */
+        template <std::size_t N>
+        const std::vector<SampleType>& realTwiddles()
+        {
+            static const std::vector<SampleType> instance = realSplitTwiddles(N);
+            return instance;
+        }
+    }
+
+    /**
+     * Prepares the shared tables used by the real and complex transforms,
+     * so that none of the transform methods builds them on first use.
+     *
+     * @param length must be equal to the template parameter
+     * @throw ConfigurationException for any other length
+     */
+    template <std::size_t Size>
+    FixedFft<Size>::FixedFft(std::size_t length):
+        Fft(length), m_real(Size), m_imag(Size)
+    {
+        if (length != Size)
+        {
+            throw ConfigurationException(
+                "FixedFft<" + std::to_string(Size) + "> cannot compute " +
+                std::to_string(length) + "-point transforms");
+        }
+        ComplexKernel<Size / 2>::tables();
+        ComplexKernel<Size>::tables();
+        realTwiddles<Size>();
+    }
+
+    /**
+     * Applies the transformation to the signal.
+     *
+     * Computes the real transform and fills the upper half of the spectrum
+     * by conjugate symmetry.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N bins)
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::fft(const SampleType x[], ComplexType spectrum[])
+    {
+        rfft(x, spectrum);
+        for (std::size_t k = Size / 2 + 1; k < Size; ++k)
+        {
+            spectrum[k] = std::conj(spectrum[Size - k]);
+        }
+    }
+
+    /**
+     * Applies the inverse transform to the spectrum.
+     *
+     * @param spectrum input spectrum (N bins)
+     * @param x output signal
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::ifft(const ComplexType spectrum[], SampleType x[])
+    {
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        ComplexKernel<Size>::load(reinterpret_cast<const SampleType*>(spectrum), re, im);
+        ComplexKernel<Size>::template transform<true>(re, im);
+        const SampleType scale = SampleType(1) / Size;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            x[i] = re[i] * scale;
+        }
+    }
+
+    /**
+     * Applies the real-input transformation to the signal.
+     *
+     * The even and odd samples are treated as real and imaginary parts of
+     * a complex signal of length N/2, which is transformed and then split
+     * into N/2+1 bins.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::rfft(const SampleType x[], ComplexType spectrum[])
+    {
+        ComplexKernel<Size / 2>::load(x, &m_real[0], &m_imag[0]);
+        transformReal(spectrum);
+    }
+
+    /**
+     * Applies the real-input transformation to a windowed signal.
+     *
+     * The window is applied while the samples are loaded in bit reversed
+     * order.
+     *
+     * @param x input signal
+     * @param window window coefficients
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::rfftWindowed(const SampleType x[], const SampleType window[],
+                                      ComplexType spectrum[])
+    {
+        ComplexKernel<Size / 2>::loadWindowed(x, window, &m_real[0], &m_imag[0]);
+        transformReal(spectrum);
+    }
+
+    /**
+     * Transforms the loaded half-length complex signal and splits it into
+     * N/2+1 bins.
+     *
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::transformReal(ComplexType spectrum[])
+    {
+        const std::size_t M = Size / 2;
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        ComplexKernel<M>::template transform<false>(re, im);
+
+        splitRealSpectrum(re, im, 1, &realTwiddles<Size>()[0], M,
+                          reinterpret_cast<SampleType*>(spectrum));
+    }
+
+    /**
+     * Applies the inverse real transform to a half spectrum.
+     *
+     * Reverses the split done by rfft(), storing the complex signal of
+     * length N/2 directly in bit reversed order, and transforms it.
+     *
+     * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+     * @param x output signal
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::irfft(const ComplexType spectrum[], SampleType x[])
+    {
+        const std::size_t M = Size / 2;
+        const SampleType* s = reinterpret_cast<const SampleType*>(spectrum);
+        const std::uint32_t* reversed = &ComplexKernel<M>::tables().reversed[0];
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+
+        // the factors of 1/2 are folded into the final scaling
+        mergeRealSpectrum(s, &realTwiddles<Size>()[0], M, reversed, re, im, 1);
+
+        ComplexKernel<M>::template transform<true>(re, im);
+        const SampleType scale = SampleType(1) / Size;
+        for (std::size_t i = 0; i < M; ++i)
+        {
+            x[2 * i] = re[i] * scale;
+            x[2 * i + 1] = im[i] * scale;
+        }
+    }
+
+    /**
+     * Applies the transformation in place.
+     *
+     * @param data complex signal on input, its spectrum on output
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::fftInPlace(ComplexType data[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        ComplexKernel<Size>::load(a, re, im);
+        ComplexKernel<Size>::template transform<false>(re, im);
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            a[2 * i] = re[i];
+            a[2 * i + 1] = im[i];
+        }
+    }
+
+    /**
+     * Applies the inverse transformation in place.
+     *
+     * @param data spectrum on input, complex signal on output
+     */
+    template <std::size_t Size>
+    void FixedFft<Size>::ifftInPlace(ComplexType data[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        ComplexKernel<Size>::load(a, re, im);
+        ComplexKernel<Size>::template transform<true>(re, im);
+        const SampleType scale = SampleType(1) / Size;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            a[2 * i] = re[i] * scale;
+            a[2 * i + 1] = im[i] * scale;
+        }
+    }
+
+    template class FixedFft<256>;
+    template class FixedFft<512>;
+    template class FixedFft<1024>;
+    template class FixedFft<2048>;
+    template class FixedFft<4096>;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file FixedFft.h
+ *
+ * FFT specialized for a transform length known at compile time.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef FIXEDFFT_H
+#define FIXEDFFT_H
+
+#include "Fft.h"
+#include <cstddef>
+#include <vector>
+
+namespace Aquila
+{
+    /**
+     * An FFT whose length is a template parameter.
+     *
+     * Every loop bound and the number of stages are compile-time constants,
+     * so the compiler can unroll and vectorize freely and the transforms
+     * contain no size checks. The algorithm is an iterative radix-4
+     * decimation in time (with a leading radix-2 pass for odd powers of 2);
+     * the first pass needs no twiddle factors and is written out by hand.
+     * The real transforms run a complex FFT of half the length and split
+     * its result, which is the usual trick for real input.
+     *
+     * Bit reversal permutations and twiddle factors are computed in double
+     * precision once per length, shared by all instances (also across
+     * threads) and never modified afterwards.
+     *
+     * The implementation lives in the library and is explicitly
+     * instantiated for lengths of 256, 512, 1024, 2048 and 4096 samples.
+     * FftFactory returns these instead of the generic OouraFft whenever
+     * the requested length matches.
+     */
+    template <std::size_t Size>
+    class AQUILA_EXPORT FixedFft : public Fft
+    {
+        static_assert(Size >= 16 && (Size & (Size - 1)) == 0,
+                      "FixedFft length must be a power of 2, at least 16");
+
+    public:
+        FixedFft(std::size_t length = Size);
+
+        using Fft::fft;
+        using Fft::ifft;
+        using Fft::rfft;
+        using Fft::irfft;
+
+        virtual void fft(const SampleType x[], ComplexType spectrum[]);
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]);
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]);
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]);
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]);
+        virtual void fftInPlace(ComplexType data[]);
+        virtual void ifftInPlace(ComplexType data[]);
+
+    private:
+        void transformReal(ComplexType spectrum[]);
+
+        /**
+         * Real parts of the signal being transformed.
+         */
+        std::vector<SampleType> m_real;
+
+        /**
+         * Imaginary parts of the signal being transformed.
+         */
+        std::vector<SampleType> m_imag;
+    };
+
+    extern template class FixedFft<256>;
+    extern template class FixedFft<512>;
+    extern template class FixedFft<1024>;
+    extern template class FixedFft<2048>;
+    extern template class FixedFft<4096>;
+}
+
+#endif // FIXEDFFT_H
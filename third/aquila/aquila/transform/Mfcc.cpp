@@ -19,6 +19,7 @@
 #include "Dct.h"
 #include "../source/SignalSource.h"
 #include "../filter/MelFilterBank.h"
+#include <complex>
 
 namespace Aquila
 {
@@ -32,7 +33,15 @@ namespace Aquila
     std::vector<double> Mfcc::calculate(const SignalSource &source,
                                         std::size_t numFeatures)
     {
-        auto spectrum = m_fft->fft(source.toArray());
+        // the real transform computes only the unique half of the
+        // spectrum, mel filters may extend beyond Nyquist frequency
+        // so the upper half is restored by mirroring
+        auto spectrum = m_fft->rfft(source.toArray());
+        spectrum.resize(m_inputSize);
+        for (std::size_t k = m_inputSize / 2 + 1; k < m_inputSize; ++k)
+        {
+            spectrum[k] = std::conj(spectrum[m_inputSize - k]);
+        }
 
         Aquila::MelFilterBank bank(source.getSampleFrequency(), m_inputSize);
         auto filterOutput = bank.applyAll(spectrum);
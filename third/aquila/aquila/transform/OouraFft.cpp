@@ -16,52 +16,92 @@
  */
 
 #include "OouraFft.h"
+#include "PlanCache.h"
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
 
+/**
+ * Float overloads, so that the code below calls the right precision
+ * of Ooura's package for the configured SampleType.
+ */
+static inline void cdft(int n, int isgn, float* a, int* ip, float* w)
+{
+    cdftf(n, isgn, a, ip, w);
+}
+
+static inline void rdft(int n, int isgn, float* a, int* ip, float* w)
+{
+    rdftf(n, isgn, a, ip, w);
+}
+
 namespace Aquila
 {
+    static_assert(
+        sizeof(ComplexType[2]) == sizeof(SampleType[4]),
+        "complex<T> has the same memory layout as two consecutive T values"
+    );
+
     /**
-     * Initializes the transform for a given input length.
+     * Builds the tables for a given input length.
      *
-     * Prepares the work area for Ooura's algorithm.
+     * Runs each transform once on silence, which makes Ooura's functions
+     * fill in the tables. The package handles powers of 2 only; tables of
+     * any other length are left empty, as there is nothing valid to
+     * compute with them anyway.
      *
      * @param length input signal size (usually a power of 2)
      */
-    OouraFft::OouraFft(std::size_t length):
-        Fft(length),
+    OouraFft::Tables::Tables(std::size_t length):
         // according to the description: "length of ip >= 2+sqrt(n)"
-        ip(new int[static_cast<std::size_t>(2 + std::sqrt(static_cast<double>(N)))]),
-        w(new double[N / 2])
+        ip(static_cast<std::size_t>(2 + std::sqrt(static_cast<double>(length))), 0),
+        w(length / 2 + 1),
+        // for the real transform: "length of ip >= 2+sqrt(n/2)"
+        rip(static_cast<std::size_t>(2 + std::sqrt(static_cast<double>(length / 2))), 0),
+        rw(length / 2 + 1)
     {
-        ip[0] = 0;
+        if (length < 2 || (length & (length - 1)) != 0)
+        {
+            return;
+        }
+        std::vector<SampleType> silence(2 * length);
+        cdft(2 * length, -1, &silence[0], &ip[0], &w[0]);
+        rdft(length, 1, &silence[0], &rip[0], &rw[0]);
     }
 
     /**
-     * Destroys the transform object and cleans up working area.
+     * Initializes the transform for a given input length.
+     *
+     * Tables are taken from the plan cache, only the work areas are
+     * allocated per object.
+     *
+     * @param length input signal size (usually a power of 2)
      */
-    OouraFft::~OouraFft()
+    OouraFft::OouraFft(std::size_t length):
+        Fft(length),
+        tables(PlanCache<Tables>::get(length)),
+        ip(tables->ip),
+        rip(tables->rip),
+        w(const_cast<SampleType*>(&tables->w[0])),
+        rw(const_cast<SampleType*>(&tables->rw[0])),
+        work(2 * N)
     {
-        delete [] w;
-        delete [] ip;
     }
 
     /**
      * Applies the transformation to the signal.
      *
+     * The output array is used as the work area for cdft(), so no
+     * temporary storage is needed.
+     *
      * @param x input signal
-     * @return calculated spectrum
+     * @param spectrum output spectrum (N bins)
      */
-    SpectrumType OouraFft::fft(const SampleType x[])
+    void OouraFft::fft(const SampleType x[], ComplexType spectrum[])
     {
-        static_assert(
-            sizeof(ComplexType[2]) == sizeof(double[4]),
-            "complex<double> has the same memory layout as two consecutive doubles"
-        );
-        // create a temporary storage array and copy input to even elements
-        // of the array (real values), leaving imaginary components at 0
-        double* a = new double[2 * N];
+        // copy input to even elements of the array (real values),
+        // leaving imaginary components at 0
+        SampleType* a = reinterpret_cast<SampleType*>(spectrum);
         for (std::size_t i = 0; i < N; ++i)
         {
             a[2 * i] = x[i];
@@ -69,42 +109,136 @@ namespace Aquila
         }
 
         // let's call the C function from Ooura's package
-        cdft(2*N, -1, a, ip, w);
-
-        // convert the array back to complex values and return as vector
-        ComplexType* tmpPtr = reinterpret_cast<ComplexType*>(a);
-        SpectrumType spectrum(tmpPtr, tmpPtr + N);
-        delete [] a;
-
-        return spectrum;
+        cdft(2*N, -1, a, &ip[0], w);
     }
 
     /**
      * Applies the inverse transform to the spectrum.
      *
-     * @param spectrum input spectrum
+     * @param spectrum input spectrum (N bins)
      * @param x output signal
      */
-    void OouraFft::ifft(SpectrumType spectrum, double x[])
+    void OouraFft::ifft(const ComplexType spectrum[], SampleType x[])
     {
-        static_assert(
-            sizeof(ComplexType[2]) == sizeof(double[4]),
-                "complex<double> has the same memory layout as two consecutive doubles"
-        );
-        // interpret the vector as consecutive pairs of doubles (re,im)
-        // and copy to input/output array
-        double* tmpPtr = reinterpret_cast<double*>(&spectrum[0]);
-        double* a = new double[2 * N];
-        std::copy(tmpPtr, tmpPtr + 2 * N, a);
+        // interpret the spectrum as consecutive pairs of values (re,im)
+        // and copy to the preallocated work area
+        const SampleType* tmpPtr = reinterpret_cast<const SampleType*>(spectrum);
+        std::copy(tmpPtr, tmpPtr + 2 * N, work.begin());
 
         // Ooura's function
-        cdft(2*N, 1, a, ip, w);
+        cdft(2*N, 1, &work[0], &ip[0], w);
 
-        // copy the data to the double array and scale it
+        // copy the real parts to the output array and scale them
         for (std::size_t i = 0; i < N; ++i)
         {
-            x[i] = a[2 * i] / static_cast<double>(N);
+            x[i] = work[2 * i] / static_cast<double>(N);
+        }
+    }
+
+    /**
+     * Applies the real-input transformation to the signal.
+     *
+     * Runs Ooura's rdft() on N real samples, which is about half the work
+     * of the complex transform, and unpacks its output in place into N/2+1
+     * bins (the output array holds N+2 values).
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void OouraFft::rfft(const SampleType x[], ComplexType spectrum[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(spectrum);
+        std::copy(x, x + N, a);
+        transformReal(a);
+    }
+
+    /**
+     * Applies the real-input transformation to a windowed signal.
+     *
+     * The windowed samples are written straight into the rdft() work
+     * array, which is the output array.
+     *
+     * @param x input signal
+     * @param window window coefficients
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void OouraFft::rfftWindowed(const SampleType x[], const SampleType window[],
+                                ComplexType spectrum[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(spectrum);
+        multiplyWindow(x, window, a, N);
+        transformReal(a);
+    }
+
+    /**
+     * Runs rdft() on N real samples and unpacks the result into N/2+1
+     * bins, in place.
+     *
+     * @param a N real samples on input, N/2+1 interleaved bins on output
+     */
+    void OouraFft::transformReal(SampleType a[])
+    {
+        rdft(N, 1, a, &rip[0], rw);
+
+        // rdft() packs R[N/2] into a[1] and computes the imaginary parts
+        // with the opposite sign convention to cdft(-1)
+        a[N] = a[1];
+        a[N + 1] = 0.0;
+        a[1] = 0.0;
+        for (std::size_t k = 1; k < N / 2; ++k)
+        {
+            a[2 * k + 1] = -a[2 * k + 1];
+        }
+    }
+
+    /**
+     * Applies the inverse real transform to a half spectrum.
+     *
+     * The output array is used as the work area for rdft().
+     *
+     * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+     * @param x output signal
+     */
+    void OouraFft::irfft(const ComplexType spectrum[], SampleType x[])
+    {
+        x[0] = spectrum[0].real();
+        x[1] = spectrum[N / 2].real();
+        for (std::size_t k = 1; k < N / 2; ++k)
+        {
+            x[2 * k] = spectrum[k].real();
+            x[2 * k + 1] = -spectrum[k].imag();
+        }
+
+        rdft(N, -1, x, &rip[0], rw);
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            x[i] *= 2.0 / static_cast<double>(N);
+        }
+    }
+
+    /**
+     * Applies the transformation in place.
+     *
+     * @param data complex signal on input, its spectrum on output
+     */
+    void OouraFft::fftInPlace(ComplexType data[])
+    {
+        cdft(2*N, -1, reinterpret_cast<SampleType*>(data), &ip[0], w);
+    }
+
+    /**
+     * Applies the inverse transformation in place.
+     *
+     * @param data spectrum on input, complex signal on output
+     */
+    void OouraFft::ifftInPlace(ComplexType data[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        cdft(2*N, 1, a, &ip[0], w);
+        for (std::size_t i = 0; i < 2 * N; ++i)
+        {
+            a[i] /= static_cast<double>(N);
         }
-        delete [] a;
     }
 }
@@ -19,10 +19,16 @@
 #define OOURAFFT_H
 
 #include "Fft.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 extern "C" {
     void cdft(int, int, double *, int *, double *);
     void rdft(int, int, double *, int *, double *);
+    // single precision build of the same package (fft4gf.c)
+    void cdftf(int, int, float *, int *, float *);
+    void rdftf(int, int, float *, int *, float *);
 }
 
 namespace Aquila
@@ -34,21 +40,97 @@ namespace Aquila
     {
     public:
         OouraFft(std::size_t length);
-        ~OouraFft();
 
-        virtual SpectrumType fft(const SampleType x[]);
-        virtual void ifft(SpectrumType spectrum, double x[]);
+        using Fft::fft;
+        using Fft::ifft;
+        using Fft::rfft;
+        using Fft::irfft;
+
+        virtual void fft(const SampleType x[], ComplexType spectrum[]);
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]);
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]);
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]);
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]);
+        virtual void fftInPlace(ComplexType data[]);
+        virtual void ifftInPlace(ComplexType data[]);
 
     private:
+        void transformReal(SampleType a[]);
+
+        /**
+         * Cos/sin tables of one transform length.
+         *
+         * Ooura's functions build their tables lazily, on the first call
+         * with a new length. Here that first call happens when the tables
+         * are created, so afterwards they are only read and can be shared
+         * by all objects of that length (see PlanCache).
+         */
+        struct Tables
+        {
+            Tables(std::size_t length);
+
+            /**
+             * Bit reversal work area as left by the initialization.
+             */
+            std::vector<int> ip;
+
+            /**
+             * Cos/sin table of the complex transform.
+             */
+            std::vector<SampleType> w;
+
+            /**
+             * Bit reversal work area of the real transform, as left by
+             * the initialization.
+             */
+            std::vector<int> rip;
+
+            /**
+             * Cos/sin table used by the real transform.
+             *
+             * rdft() splits its table between twiddles and the real-to-complex
+             * post-processing factors, so it cannot share w with cdft().
+             */
+            std::vector<SampleType> rw;
+        };
+
+        /**
+         * Shared tables of this length.
+         */
+        std::shared_ptr<const Tables> tables;
+
         /**
          * Work area for bit reversal.
+         *
+         * Ooura's functions write to it on every call, so each object needs
+         * its own copy; its header tells them the tables are ready.
+         */
+        std::vector<int> ip;
+
+        /**
+         * Work area for bit reversal used by the real transform.
+         */
+        std::vector<int> rip;
+
+        /**
+         * Cos/sin table, the shared one.
+         *
+         * The C interface takes a mutable pointer, but with initialized
+         * tables Ooura's functions only read it.
+         */
+        SampleType* w;
+
+        /**
+         * Cos/sin table used by the real transform, the shared one.
          */
-        int* ip;
+        SampleType* rw;
 
         /**
-         * Cos/sin table.
+         * Scratch area for the inverse transform, which must not
+         * overwrite its input.
          */
-        double* w;
+        std::vector<SampleType> work;
     };
 }
 
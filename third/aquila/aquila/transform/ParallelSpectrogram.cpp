@@ -0,0 +1,220 @@
+/**
+ * @file ParallelSpectrogram.cpp
+ *
+ * Spectrogram calculation spread over several threads.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "ParallelSpectrogram.h"
+#include "FftFactory.h"
+#include "../Exceptions.h"
+#include "../source/FramesCollection.h"
+#include "../source/FrameView.h"
+#include <algorithm>
+
+namespace Aquila
+{
+    /**
+     * Starts computing the spectra of a collection of frames.
+     *
+     * @param frames input frames
+     * @param threadCount number of worker threads, 0 for one per core
+     * @param chunkSize frames per chunk
+     * @throw Aquila::ConfigurationException for a zero chunk size
+     */
+    ParallelSpectrogram::ParallelSpectrogram(FramesCollection& frames,
+                                             std::size_t threadCount,
+                                             std::size_t chunkSize):
+        ParallelSpectrogram(frames.views(), threadCount, chunkSize)
+    {
+    }
+
+    /**
+     * Starts computing the spectra of frame views.
+     *
+     * @param frames input frames
+     * @param threadCount number of worker threads, 0 for one per core
+     * @param chunkSize frames per chunk
+     * @throw Aquila::ConfigurationException for a zero chunk size
+     */
+    ParallelSpectrogram::ParallelSpectrogram(const FrameViewRange& frames,
+                                             std::size_t threadCount,
+                                             std::size_t chunkSize):
+        m_frameCount(frames.count()),
+        m_spectrumSize(frames.getSamplesPerFrame()),
+        m_chunkSize(chunkSize),
+        m_chunkCount(0),
+        m_threadCount(threadCount),
+        m_inputs(),
+        m_data(),
+        m_ffts(),
+        m_queues(),
+        m_done(),
+        m_doneCount(0),
+        m_doneMutex(),
+        m_doneCondition(),
+        m_cancelled(false),
+        m_threads()
+    {
+        if (0 == m_chunkSize)
+        {
+            throw ConfigurationException("Chunk size must not be zero!");
+        }
+        m_chunkCount = (m_frameCount + m_chunkSize - 1) / m_chunkSize;
+        m_data.reset(new SpectrumType(m_frameCount * (m_spectrumSize / 2 + 1)));
+        m_done.resize(m_chunkCount, 0);
+
+        m_inputs.reserve(m_frameCount);
+        for (auto it = frames.begin(); it != frames.end(); ++it)
+        {
+            m_inputs.push_back((*it).toArray());
+        }
+
+        if (0 == m_threadCount)
+        {
+            m_threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_threadCount = std::min(m_threadCount, m_chunkCount);
+
+        // FFT objects are created here, so that a wrong frame length
+        // throws from the constructor and not from a worker thread
+        m_queues.reset(new WorkQueue[m_threadCount]);
+        for (std::size_t w = 0; w < m_threadCount; ++w)
+        {
+            m_ffts.push_back(FftFactory::getFft(m_spectrumSize));
+            m_queues[w].front = 0;
+            m_queues[w].back = (m_chunkCount - w + m_threadCount - 1) / m_threadCount;
+        }
+        for (std::size_t w = 0; w < m_threadCount; ++w)
+        {
+            m_threads.push_back(std::thread(&ParallelSpectrogram::work, this, w));
+        }
+    }
+
+    /**
+     * Stops the computation of the remaining chunks and waits for the
+     * worker threads.
+     */
+    ParallelSpectrogram::~ParallelSpectrogram()
+    {
+        m_cancelled = true;
+        for (std::size_t w = 0; w < m_threads.size(); ++w)
+        {
+            m_threads[w].join();
+        }
+    }
+
+    /**
+     * Returns number of frames in a given chunk.
+     *
+     * @param chunk chunk number
+     * @return frame count
+     */
+    std::size_t ParallelSpectrogram::getChunkFrameCount(std::size_t chunk) const
+    {
+        return std::min(m_chunkSize, m_frameCount - chunk * m_chunkSize);
+    }
+
+    /**
+     * Waits until a chunk is computed and returns its spectra.
+     *
+     * @param chunk chunk number
+     * @return spectra of getChunkFrameCount(chunk) consecutive frames,
+     *         N/2+1 bins each
+     */
+    const ComplexType* ParallelSpectrogram::waitForChunk(std::size_t chunk)
+    {
+        std::unique_lock<std::mutex> lock(m_doneMutex);
+        m_doneCondition.wait(lock, [this, chunk] { return m_done[chunk] != 0; });
+        return &(*m_data)[chunk * m_chunkSize * (m_spectrumSize / 2 + 1)];
+    }
+
+    /**
+     * Waits until all chunks are computed.
+     */
+    void ParallelSpectrogram::waitForAll()
+    {
+        std::unique_lock<std::mutex> lock(m_doneMutex);
+        m_doneCondition.wait(lock, [this] { return m_doneCount == m_chunkCount; });
+    }
+
+    /**
+     * Waits until all chunks are computed and returns the spectra.
+     *
+     * @return shared spectra of all frames
+     */
+    std::shared_ptr<SpectrumType> ParallelSpectrogram::getData()
+    {
+        waitForAll();
+        return m_data;
+    }
+
+    /**
+     * Picks the next chunk for a worker.
+     *
+     * Takes the earliest chunk of the worker's own queue, or the latest
+     * chunk of another worker's queue when its own is empty.
+     *
+     * @param worker worker number
+     * @param chunk picked chunk number
+     * @return false when no work is left
+     */
+    bool ParallelSpectrogram::takeChunk(std::size_t worker, std::size_t& chunk)
+    {
+        const std::size_t threadCount = m_threadCount;
+        {
+            WorkQueue& own = m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.front < own.back)
+            {
+                chunk = own.front++ * threadCount + worker;
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < threadCount; ++i)
+        {
+            const std::size_t victim = (worker + i) % threadCount;
+            WorkQueue& other = m_queues[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (other.front < other.back)
+            {
+                chunk = --other.back * threadCount + victim;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Worker thread body.
+     *
+     * @param worker worker number
+     */
+    void ParallelSpectrogram::work(std::size_t worker)
+    {
+        const std::size_t bins = m_spectrumSize / 2 + 1;
+        Fft& fft = *m_ffts[worker];
+        std::size_t chunk = 0;
+        while (!m_cancelled && takeChunk(worker, chunk))
+        {
+            const std::size_t first = chunk * m_chunkSize;
+            fft.rfftBatch(&m_inputs[first], getChunkFrameCount(chunk),
+                          &(*m_data)[first * bins]);
+
+            std::lock_guard<std::mutex> lock(m_doneMutex);
+            m_done[chunk] = 1;
+            ++m_doneCount;
+            m_doneCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,212 @@
+/**
+ * @file ParallelSpectrogram.h
+ *
+ * Spectrogram calculation spread over several threads.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef PARALLELSPECTROGRAM_H
+#define PARALLELSPECTROGRAM_H
+
+#include "../global.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Aquila
+{
+    class Fft;
+    class FrameViewRange;
+    class FramesCollection;
+
+    /**
+     * Computes frame spectra in the background on a pool of threads.
+     *
+     * Frames are grouped in chunks of consecutive frames. Chunks are dealt
+     * out round robin to the worker threads, each worker computes its own
+     * chunks from the earliest one and, when it runs out of work, steals
+     * the latest remaining chunk of another worker. Every chunk is always
+     * transformed the same way and written to its own place, so the result
+     * does not depend on the number of threads or on scheduling.
+     *
+     * The computation starts in the constructor. Chunks can be consumed in
+     * order with waitForChunk() while later ones are still being computed,
+     * or all at once after waitForAll(). The signal the frames were made of
+     * must outlive this object.
+     *
+     * Spectra are stored like in Spectrogram: N/2+1 bins per frame, all
+     * frames in one array.
+     */
+    class AQUILA_EXPORT ParallelSpectrogram
+    {
+    public:
+        ParallelSpectrogram(FramesCollection& frames, std::size_t threadCount = 0,
+                            std::size_t chunkSize = 64);
+        ParallelSpectrogram(const FrameViewRange& frames, std::size_t threadCount = 0,
+                            std::size_t chunkSize = 64);
+        ~ParallelSpectrogram();
+
+        /**
+         * Returns number of frames.
+         *
+         * @return frame count
+         */
+        std::size_t getFrameCount() const
+        {
+            return m_frameCount;
+        }
+
+        /**
+         * Returns spectrum size (frame length).
+         *
+         * @return spectrum size
+         */
+        std::size_t getSpectrumSize() const
+        {
+            return m_spectrumSize;
+        }
+
+        /**
+         * Returns number of worker threads.
+         *
+         * @return thread count
+         */
+        std::size_t getThreadCount() const
+        {
+            return m_threadCount;
+        }
+
+        /**
+         * Returns number of frames in a chunk (except maybe the last one).
+         *
+         * @return chunk size
+         */
+        std::size_t getChunkSize() const
+        {
+            return m_chunkSize;
+        }
+
+        /**
+         * Returns number of chunks.
+         *
+         * @return chunk count
+         */
+        std::size_t getChunkCount() const
+        {
+            return m_chunkCount;
+        }
+
+        std::size_t getChunkFrameCount(std::size_t chunk) const;
+        const ComplexType* waitForChunk(std::size_t chunk);
+        void waitForAll();
+        std::shared_ptr<SpectrumType> getData();
+
+    private:
+        /**
+         * Chunks assigned to one worker.
+         *
+         * Worker w owns chunks w, w + T, w + 2T, ... (T threads); front
+         * and back count them in that sequence.
+         */
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::size_t front;
+            std::size_t back;
+        };
+
+        bool takeChunk(std::size_t worker, std::size_t& chunk);
+        void work(std::size_t worker);
+
+        /**
+         * Frame count.
+         */
+        std::size_t m_frameCount;
+
+        /**
+         * Spectrum size.
+         */
+        std::size_t m_spectrumSize;
+
+        /**
+         * Frames per chunk.
+         */
+        std::size_t m_chunkSize;
+
+        /**
+         * Chunk count.
+         */
+        std::size_t m_chunkCount;
+
+        /**
+         * Number of worker threads.
+         */
+        std::size_t m_threadCount;
+
+        /**
+         * Samples of each frame.
+         */
+        std::vector<const SampleType*> m_inputs;
+
+        /**
+         * Spectra of all frames.
+         */
+        std::shared_ptr<SpectrumType> m_data;
+
+        /**
+         * One FFT object per worker.
+         */
+        std::vector<std::shared_ptr<Fft>> m_ffts;
+
+        /**
+         * Work queue of each worker.
+         */
+        std::unique_ptr<WorkQueue[]> m_queues;
+
+        /**
+         * Completion flag of each chunk, guarded by m_doneMutex.
+         */
+        std::vector<char> m_done;
+
+        /**
+         * Number of completed chunks, guarded by m_doneMutex.
+         */
+        std::size_t m_doneCount;
+
+        /**
+         * Guards the completion flags.
+         */
+        std::mutex m_doneMutex;
+
+        /**
+         * Signalled whenever a chunk completes.
+         */
+        std::condition_variable m_doneCondition;
+
+        /**
+         * Set by the destructor to stop the workers early.
+         */
+        std::atomic<bool> m_cancelled;
+
+        /**
+         * Worker threads.
+         */
+        std::vector<std::thread> m_threads;
+    };
+}
+
+#endif // PARALLELSPECTROGRAM_H
@@ -0,0 +1,371 @@
+/**
+ * @file PeakPicker.cpp
+ *
+ * Single-pass spectral peak picking.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "PeakPicker.h"
+#include "../functions.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace Aquila
+{
+    /**
+     * Creates the peak picker for a given spectrum size and band.
+     *
+     * @param spectrumSize number of bins in the analysed spectra
+     * @param firstBin first bin of the band
+     * @param lastBin one past the last bin of the band
+     * @param maxPeaks how many peaks to find
+     * @param interpolation sub-bin interpolation method
+     */
+    PeakPicker::PeakPicker(std::size_t spectrumSize, std::size_t firstBin,
+                           std::size_t lastBin, std::size_t maxPeaks,
+                           InterpolationType interpolation):
+        m_spectrumSize(spectrumSize),
+        m_firstBin(std::min(firstBin, spectrumSize)),
+        m_lastBin(std::min(lastBin, spectrumSize)),
+        m_power(spectrumSize + 1, 0.0),
+        m_peaks(std::max<std::size_t>(maxPeaks, 1)),
+        m_peakCount(0),
+        m_totalPower(0.0),
+        m_interpolation(interpolation)
+    {
+        if (m_lastBin < m_firstBin)
+        {
+            m_lastBin = m_firstBin;
+        }
+    }
+
+    /**
+     * Finds the strongest peaks of the spectrum within the band.
+     *
+     * Does not allocate memory.
+     *
+     * @param spectrum spectrum with at least spectrumSize bins
+     * @return number of peaks found
+     */
+    std::size_t PeakPicker::pick(const ComplexType spectrum[])
+    {
+        m_peakCount = 0;
+        m_totalPower = 0.0;
+        if (m_lastBin == m_firstBin)
+        {
+            return 0;
+        }
+
+        std::size_t maxIndex = 0;
+        m_totalPower = spectralPower(spectrum + m_firstBin,
+                                     m_lastBin - m_firstBin,
+                                     &m_power[m_firstBin], maxIndex);
+
+        if (m_peaks.size() == 1)
+        {
+            const std::size_t bin = m_firstBin + maxIndex;
+            if (m_power[bin] > 0.0)
+            {
+                m_peaks[0].bin = bin;
+                m_peaks[0].power = m_power[bin];
+                m_peaks[0].position = static_cast<double>(bin);
+                m_peakCount = 1;
+            }
+        }
+        else
+        {
+            selectLocalMaxima();
+        }
+
+        for (std::size_t i = 0; i < m_peakCount; ++i)
+        {
+            m_peaks[i].position = interpolate(spectrum, m_peaks[i].bin);
+        }
+
+        return m_peakCount;
+    }
+
+    /**
+     * Estimates the fractional position of a peak from its neighbours.
+     *
+     * @param spectrum analysed spectrum
+     * @param bin peak bin number
+     * @return peak position in bins
+     */
+    double PeakPicker::interpolate(const ComplexType spectrum[],
+                                   std::size_t bin) const
+    {
+        if (m_interpolation == None || bin == 0 || bin + 1 >= m_spectrumSize)
+        {
+            return static_cast<double>(bin);
+        }
+
+        double delta = 0.0;
+        if (m_interpolation == Complex)
+        {
+            const ComplexType denominator =
+                SampleType(2) * spectrum[bin] - spectrum[bin - 1] - spectrum[bin + 1];
+            if (std::norm(denominator) > 0.0)
+            {
+                delta = -((spectrum[bin + 1] - spectrum[bin - 1]) / denominator).real();
+            }
+        }
+        else
+        {
+            const double left = std::norm(spectrum[bin - 1]);
+            const double center = std::norm(spectrum[bin]);
+            const double right = std::norm(spectrum[bin + 1]);
+            double a, b, c;
+            if (m_interpolation == Gaussian)
+            {
+                if (left <= 0.0 || center <= 0.0 || right <= 0.0)
+                {
+                    return static_cast<double>(bin);
+                }
+                // log of power is twice the log of magnitude, which
+                // does not change the vertex of the parabola
+                a = std::log(left);
+                b = std::log(center);
+                c = std::log(right);
+            }
+            else
+            {
+                a = std::sqrt(left);
+                b = std::sqrt(center);
+                c = std::sqrt(right);
+            }
+            const double denominator = a - 2.0 * b + c;
+            if (denominator < 0.0)
+            {
+                delta = 0.5 * (a - c) / denominator;
+            }
+        }
+
+        return bin + clamp(-0.5, delta, 0.5);
+    }
+
+    /**
+     * Selects the strongest local maxima of the power spectrum.
+     */
+    void PeakPicker::selectLocalMaxima()
+    {
+        const std::size_t maxPeaks = m_peaks.size();
+        for (std::size_t bin = m_firstBin; bin < m_lastBin; ++bin)
+        {
+            const double p = m_power[bin];
+            if (p <= 0.0 ||
+                (bin > m_firstBin && p <= m_power[bin - 1]) ||
+                (bin + 1 < m_lastBin && p < m_power[bin + 1]))
+            {
+                continue;
+            }
+            if (m_peakCount == maxPeaks && p <= m_peaks[maxPeaks - 1].power)
+            {
+                continue;
+            }
+
+            // insertion into the short sorted list of peaks
+            std::size_t pos = std::min(m_peakCount, maxPeaks - 1);
+            while (pos > 0 && m_peaks[pos - 1].power < p)
+            {
+                m_peaks[pos] = m_peaks[pos - 1];
+                --pos;
+            }
+            m_peaks[pos].bin = bin;
+            m_peaks[pos].power = p;
+            m_peaks[pos].position = static_cast<double>(bin);
+            if (m_peakCount < maxPeaks)
+            {
+                ++m_peakCount;
+            }
+        }
+    }
+
+    /**
+     * Calculates squared magnitudes of a run of spectrum bins.
+     *
+     * This is the vectorized kernel behind PeakPicker. In one pass it
+     * stores the power of every bin, sums them up and tracks the position
+     * of the maximum (the first one, if there is a tie).
+     *
+     * @param spectrum first bin to process
+     * @param count number of bins
+     * @param power output array for squared magnitudes (count values)
+     * @param maxIndex output - index of the strongest bin
+     * @return total power of all processed bins
+     */
+    double spectralPower(const ComplexType spectrum[], std::size_t count,
+                         SampleType power[], std::size_t& maxIndex)
+    {
+        const SampleType* data = reinterpret_cast<const SampleType*>(spectrum);
+        double total = 0.0, maxPower = -1.0;
+        std::size_t i = 0;
+        maxIndex = 0;
+
+#if defined(AQUILA_SINGLE_PRECISION) && defined(__AVX2__)
+        // powers are summed in double, four bins per accumulator
+        __m256d vsumLow = _mm256_setzero_pd(), vsumHigh = _mm256_setzero_pd();
+        __m256 vmax = _mm256_set1_ps(-1.0f);
+        __m256 vmaxIdx = _mm256_setzero_ps();
+        __m256 vidx = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const __m256 step = _mm256_set1_ps(8.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 a = _mm256_loadu_ps(data + 2 * i);
+            __m256 b = _mm256_loadu_ps(data + 2 * i + 8);
+            a = _mm256_mul_ps(a, a);
+            b = _mm256_mul_ps(b, b);
+            // hadd works within 128-bit lanes, giving p0 p1 p4 p5 p2 p3 p6 p7
+            __m256 p = _mm256_hadd_ps(a, b);
+            p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p),
+                                                       _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(power + i, p);
+            vsumLow = _mm256_add_pd(vsumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(p)));
+            vsumHigh = _mm256_add_pd(vsumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(p, 1)));
+            __m256 greater = _mm256_cmp_ps(p, vmax, _CMP_GT_OQ);
+            vmax = _mm256_blendv_ps(vmax, p, greater);
+            vmaxIdx = _mm256_blendv_ps(vmaxIdx, vidx, greater);
+            vidx = _mm256_add_ps(vidx, step);
+        }
+        const std::size_t lanes = 8;
+        double sums[lanes];
+        float maxima[lanes], indices[lanes];
+        _mm256_storeu_pd(sums, vsumLow);
+        _mm256_storeu_pd(sums + 4, vsumHigh);
+        _mm256_storeu_ps(maxima, vmax);
+        _mm256_storeu_ps(indices, vmaxIdx);
+#elif defined(AQUILA_SINGLE_PRECISION) && defined(__SSE2__)
+        // powers are summed in double, two bins per accumulator
+        __m128d vsumLow = _mm_setzero_pd(), vsumHigh = _mm_setzero_pd();
+        __m128 vmax = _mm_set1_ps(-1.0f);
+        __m128 vmaxIdx = _mm_setzero_ps();
+        __m128 vidx = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 step = _mm_set1_ps(4.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 a = _mm_loadu_ps(data + 2 * i);
+            __m128 b = _mm_loadu_ps(data + 2 * i + 4);
+            a = _mm_mul_ps(a, a);
+            b = _mm_mul_ps(b, b);
+            // real parts are the even elements, imaginary parts the odd ones
+            __m128 p = _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+                                  _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            _mm_storeu_ps(power + i, p);
+            vsumLow = _mm_add_pd(vsumLow, _mm_cvtps_pd(p));
+            vsumHigh = _mm_add_pd(vsumHigh, _mm_cvtps_pd(_mm_movehl_ps(p, p)));
+            __m128 greater = _mm_cmpgt_ps(p, vmax);
+            vmax = _mm_or_ps(_mm_and_ps(greater, p), _mm_andnot_ps(greater, vmax));
+            vmaxIdx = _mm_or_ps(_mm_and_ps(greater, vidx), _mm_andnot_ps(greater, vmaxIdx));
+            vidx = _mm_add_ps(vidx, step);
+        }
+        const std::size_t lanes = 4;
+        double sums[lanes];
+        float maxima[lanes], indices[lanes];
+        _mm_storeu_pd(sums, vsumLow);
+        _mm_storeu_pd(sums + 2, vsumHigh);
+        _mm_storeu_ps(maxima, vmax);
+        _mm_storeu_ps(indices, vmaxIdx);
+#elif defined(__AVX2__)
+        __m256d vsum = _mm256_setzero_pd();
+        __m256d vmax = _mm256_set1_pd(-1.0);
+        __m256d vmaxIdx = _mm256_setzero_pd();
+        __m256d vidx = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+        const __m256d step = _mm256_set1_pd(4.0);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256d a = _mm256_loadu_pd(data + 2 * i);
+            __m256d b = _mm256_loadu_pd(data + 2 * i + 4);
+            a = _mm256_mul_pd(a, a);
+            b = _mm256_mul_pd(b, b);
+            // hadd works within 128-bit lanes, giving p0 p2 p1 p3
+            __m256d p = _mm256_hadd_pd(a, b);
+            p = _mm256_permute4x64_pd(p, _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_pd(power + i, p);
+            vsum = _mm256_add_pd(vsum, p);
+            __m256d greater = _mm256_cmp_pd(p, vmax, _CMP_GT_OQ);
+            vmax = _mm256_blendv_pd(vmax, p, greater);
+            vmaxIdx = _mm256_blendv_pd(vmaxIdx, vidx, greater);
+            vidx = _mm256_add_pd(vidx, step);
+        }
+        const std::size_t lanes = 4;
+        double sums[lanes], maxima[lanes], indices[lanes];
+        _mm256_storeu_pd(sums, vsum);
+        _mm256_storeu_pd(maxima, vmax);
+        _mm256_storeu_pd(indices, vmaxIdx);
+#elif defined(__SSE2__)
+        __m128d vsum = _mm_setzero_pd();
+        __m128d vmax = _mm_set1_pd(-1.0);
+        __m128d vmaxIdx = _mm_setzero_pd();
+        __m128d vidx = _mm_setr_pd(0.0, 1.0);
+        const __m128d step = _mm_set1_pd(2.0);
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128d a = _mm_loadu_pd(data + 2 * i);
+            __m128d b = _mm_loadu_pd(data + 2 * i + 2);
+            a = _mm_mul_pd(a, a);
+            b = _mm_mul_pd(b, b);
+            __m128d p = _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+            _mm_storeu_pd(power + i, p);
+            vsum = _mm_add_pd(vsum, p);
+            __m128d greater = _mm_cmpgt_pd(p, vmax);
+            vmax = _mm_or_pd(_mm_and_pd(greater, p), _mm_andnot_pd(greater, vmax));
+            vmaxIdx = _mm_or_pd(_mm_and_pd(greater, vidx), _mm_andnot_pd(greater, vmaxIdx));
+            vidx = _mm_add_pd(vidx, step);
+        }
+        const std::size_t lanes = 2;
+        double sums[lanes], maxima[lanes], indices[lanes];
+        _mm_storeu_pd(sums, vsum);
+        _mm_storeu_pd(maxima, vmax);
+        _mm_storeu_pd(indices, vmaxIdx);
+#else
+        const std::size_t lanes = 0;
+        SampleType sums[1], maxima[1], indices[1];
+#endif
+
+        // reduce the vector lanes, preferring the lowest index on ties
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            total += sums[lane];
+            const std::size_t index = static_cast<std::size_t>(indices[lane]);
+            if (maxima[lane] > maxPower ||
+                (maxima[lane] == maxPower && index < maxIndex))
+            {
+                maxPower = maxima[lane];
+                maxIndex = index;
+            }
+        }
+
+        // scalar tail (or the whole run without SIMD)
+        for (; i < count; ++i)
+        {
+            const SampleType re = data[2 * i], im = data[2 * i + 1];
+            const SampleType p = re * re + im * im;
+            power[i] = p;
+            total += p;
+            if (p > maxPower)
+            {
+                maxPower = p;
+                maxIndex = i;
+            }
+        }
+
+        return total;
+    }
+}
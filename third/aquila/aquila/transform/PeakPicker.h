@@ -0,0 +1,234 @@
+/**
+ * @file PeakPicker.h
+ *
+ * Single-pass spectral peak picking.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef PEAKPICKER_H
+#define PEAKPICKER_H
+
+#include "../global.h"
+#include <cstddef>
+#include <vector>
+
+namespace Aquila
+{
+    /**
+     * A single spectral peak.
+     */
+    struct AQUILA_EXPORT SpectralPeak
+    {
+        /**
+         * Spectrum bin number.
+         */
+        std::size_t bin;
+
+        /**
+         * Squared magnitude of the bin.
+         */
+        double power;
+
+        /**
+         * Peak position in (fractional) bins.
+         *
+         * Equal to the bin number unless an interpolation is enabled.
+         */
+        double position;
+    };
+
+    /**
+     * Finds the strongest peaks in a band of a spectrum.
+     *
+     * The picker is configured once for a spectrum size and a band of bins,
+     * all storage is allocated in the constructor. Each call to pick() then
+     * makes a single pass over the band, computing squared magnitudes
+     * (there is no square root per bin) together with the running maximum
+     * and the total energy. The pass is vectorized with AVX2 or SSE2 when
+     * the compiler targets them, with a scalar fallback otherwise.
+     *
+     * When more than one peak is requested, local maxima are then selected
+     * from the already computed power values.
+     *
+     * The true frequency of a sinusoid usually falls between two bins.
+     * The picker can estimate it from the peak and its two neighbours:
+     *
+     * - Parabolic - fits a parabola to the magnitudes
+     * - Gaussian - fits a parabola to the log-magnitudes, which is exact
+     *   for a Gaussian window and very close for Hamming/Hann windows
+     * - Complex - quadratic interpolation on the complex spectrum
+     *   (Jacobsen's estimator), best suited for a rectangular window
+     *
+     * Example - dominant frequency of a real signal:
+     *
+     * @code
+     * auto fft = FftFactory::getFft(SIZE);
+     * SpectrumType spectrum(SIZE / 2 + 1);
+     * PeakPicker picker(SIZE / 2 + 1, 1, SIZE / 2);
+     * fft->rfft(signal, &spectrum[0]);
+     * if (picker.pick(&spectrum[0]) > 0)
+     *     frequency = picker.getPeak(0).position * sampleFrequency / SIZE;
+     * @endcode
+     */
+    class AQUILA_EXPORT PeakPicker
+    {
+    public:
+        /**
+         * Sub-bin peak interpolation method.
+         */
+        enum InterpolationType {None, Parabolic, Gaussian, Complex};
+
+        PeakPicker(std::size_t spectrumSize, std::size_t firstBin,
+                   std::size_t lastBin, std::size_t maxPeaks = 1,
+                   InterpolationType interpolation = None);
+
+        /**
+         * Sets the sub-bin interpolation method.
+         *
+         * @param interpolation interpolation method
+         */
+        void setInterpolation(InterpolationType interpolation)
+        {
+            m_interpolation = interpolation;
+        }
+
+        /**
+         * Returns the sub-bin interpolation method.
+         *
+         * @return interpolation method
+         */
+        InterpolationType getInterpolation() const
+        {
+            return m_interpolation;
+        }
+
+        std::size_t pick(const ComplexType spectrum[]);
+
+        /**
+         * Returns the number of peaks found by the last pick() call.
+         *
+         * @return peak count (at most the configured maximum)
+         */
+        std::size_t getPeakCount() const
+        {
+            return m_peakCount;
+        }
+
+        /**
+         * Returns a peak found by the last pick() call.
+         *
+         * Peaks are sorted by power, strongest first.
+         *
+         * @param index peak number
+         * @return peak data
+         */
+        const SpectralPeak& getPeak(std::size_t index) const
+        {
+            return m_peaks[index];
+        }
+
+        /**
+         * Returns the total energy of the band from the last pick() call.
+         *
+         * @return sum of squared magnitudes of all bins in the band
+         */
+        double getTotalPower() const
+        {
+            return m_totalPower;
+        }
+
+        /**
+         * Returns squared magnitudes computed by the last pick() call.
+         *
+         * The array is indexed by bin number; only bins inside the band
+         * hold meaningful values.
+         *
+         * @return power spectrum
+         */
+        const SampleType* getPowerSpectrum() const
+        {
+            return &m_power[0];
+        }
+
+        /**
+         * Returns the first bin of the band.
+         *
+         * @return bin number
+         */
+        std::size_t getFirstBin() const
+        {
+            return m_firstBin;
+        }
+
+        /**
+         * Returns one past the last bin of the band.
+         *
+         * @return bin number
+         */
+        std::size_t getLastBin() const
+        {
+            return m_lastBin;
+        }
+
+    private:
+        void selectLocalMaxima();
+
+        double interpolate(const ComplexType spectrum[], std::size_t bin) const;
+
+        /**
+         * Number of bins in the analysed spectra.
+         */
+        std::size_t m_spectrumSize;
+
+        /**
+         * First bin of the band.
+         */
+        std::size_t m_firstBin;
+
+        /**
+         * One past the last bin of the band.
+         */
+        std::size_t m_lastBin;
+
+        /**
+         * Squared magnitude of each bin.
+         */
+        std::vector<SampleType> m_power;
+
+        /**
+         * Strongest peaks, sorted by power.
+         */
+        std::vector<SpectralPeak> m_peaks;
+
+        /**
+         * Number of valid entries in m_peaks.
+         */
+        std::size_t m_peakCount;
+
+        /**
+         * Total energy of the band.
+         */
+        double m_totalPower;
+
+        /**
+         * Sub-bin interpolation method.
+         */
+        InterpolationType m_interpolation;
+    };
+
+    AQUILA_EXPORT double spectralPower(const ComplexType spectrum[],
+                                       std::size_t count, SampleType power[],
+                                       std::size_t& maxIndex);
+}
+
+#endif // PEAKPICKER_H
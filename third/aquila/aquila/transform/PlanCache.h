@@ -0,0 +1,72 @@
+/**
+ * @file PlanCache.h
+ *
+ * Process-wide cache of immutable FFT tables.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef PLANCACHE_H
+#define PLANCACHE_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace Aquila
+{
+    /**
+     * Shares the tables of an FFT implementation between all its objects.
+     *
+     * Plan is the table type of one backend, constructible from a
+     * transform length. The cache is keyed by that type and the length;
+     * the tables of all backends here serve both transform directions,
+     * so the direction is not a part of the key.
+     *
+     * Each distinct plan is built once, by the first object which needs
+     * it, and kept for the lifetime of the process. Plans are immutable
+     * after construction, so any number of threads may read them. Anything
+     * a transform writes to (scratch buffers, work areas) must stay in the
+     * FFT object itself, which therefore is still meant to be used by one
+     * thread at a time - but creating one per thread is cheap.
+     */
+    template <typename Plan>
+    class PlanCache
+    {
+    public:
+        /**
+         * Returns the shared plan for a transform length.
+         *
+         * Thread safe. Takes a lock, so call it when setting up, not from
+         * real-time code.
+         *
+         * @param length transform length
+         * @return immutable plan
+         */
+        static std::shared_ptr<const Plan> get(std::size_t length)
+        {
+            static std::mutex mutex;
+            static std::map<std::size_t, std::shared_ptr<const Plan>> plans;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::shared_ptr<const Plan>& plan = plans[length];
+            if (!plan)
+            {
+                plan = std::make_shared<const Plan>(length);
+            }
+            return plan;
+        }
+    };
+}
+
+#endif // PLANCACHE_H
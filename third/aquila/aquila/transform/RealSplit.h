@@ -0,0 +1,216 @@
+/**
+ * @file RealSplit.h
+ *
+ * Tables and real spectrum split/merge shared by the FFT backends.
+ * Internal header, not a part of the public interface.
+ *
+ * A real transform of N samples is computed as a complex transform of
+ * the N/2 values z[n] = x[2n] + i x[2n+1], whose spectrum Z is then split
+ * into the N/2+1 bins of the real one; the inverse merges the bins back
+ * into Z. AquilaFft, FixedFft and SimdFft all do it this way, here is the
+ * only copy of the math.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef REALSPLIT_H
+#define REALSPLIT_H
+
+#include "../global.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Aquila
+{
+    // Internal linkage, like the kernels in SimdFftKernels.h: every
+    // translation unit compiles its own copy with its own flags.
+    namespace
+    {
+        /**
+         * Returns the bit reversed index of each position.
+         *
+         * @param length number of positions, a power of 2
+         * @return permutation of 0..length-1
+         */
+        inline std::vector<std::uint32_t> bitReversedIndices(std::size_t length)
+        {
+            std::size_t bits = 0;
+            while ((std::size_t(1) << bits) < length)
+            {
+                ++bits;
+            }
+
+            std::vector<std::uint32_t> reversed(length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                std::uint32_t j = 0;
+                for (std::size_t bit = 0; bit < bits; ++bit)
+                {
+                    j |= static_cast<std::uint32_t>((i >> bit) & 1u) << (bits - 1 - bit);
+                }
+                reversed[i] = j;
+            }
+            return reversed;
+        }
+
+        /**
+         * Returns the twiddles of all radix-4 passes of a transform.
+         *
+         * The twiddles of each pass combining sub-transforms of length L
+         * are stored as runs of L values: Re W^k, Im W^k, Re W^2k, Im W^2k,
+         * where W = exp(-2 pi i / 4L). They are computed in double
+         * precision.
+         *
+         * @param length transform length, a power of 2
+         * @param firstLength sub-transform length after the first pass
+         * @return twiddles of all passes, in order
+         */
+        inline std::vector<SampleType> radix4Twiddles(std::size_t length,
+                                                      std::size_t firstLength)
+        {
+            std::vector<SampleType> twiddles;
+            for (std::size_t L = firstLength; 4 * L <= length; L *= 4)
+            {
+                const double step = -2.0 * M_PI / (4.0 * L);
+                for (std::size_t k = 0; k < L; ++k)
+                {
+                    twiddles.push_back(static_cast<SampleType>(std::cos(step * k)));
+                }
+                for (std::size_t k = 0; k < L; ++k)
+                {
+                    twiddles.push_back(static_cast<SampleType>(std::sin(step * k)));
+                }
+                for (std::size_t k = 0; k < L; ++k)
+                {
+                    twiddles.push_back(static_cast<SampleType>(std::cos(2.0 * step * k)));
+                }
+                for (std::size_t k = 0; k < L; ++k)
+                {
+                    twiddles.push_back(static_cast<SampleType>(std::sin(2.0 * step * k)));
+                }
+            }
+            return twiddles;
+        }
+
+        /**
+         * Returns the twiddles W^k = exp(-2 pi i k / N) for k = 0..N/4,
+         * as interleaved real and imaginary parts.
+         *
+         * @param length real transform length N
+         * @return 2 * (N/4 + 1) values
+         */
+        inline std::vector<SampleType> realSplitTwiddles(std::size_t length)
+        {
+            std::vector<SampleType> twiddles(2 * (length / 4 + 1));
+            for (std::size_t k = 0; k <= length / 4; ++k)
+            {
+                twiddles[2 * k] = static_cast<SampleType>(std::cos(-2.0 * M_PI * k / length));
+                twiddles[2 * k + 1] = static_cast<SampleType>(std::sin(-2.0 * M_PI * k / length));
+            }
+            return twiddles;
+        }
+
+        /**
+         * Splits the spectrum Z of the half-length complex signal into
+         * the N/2+1 bins of the real spectrum X.
+         *
+         * Every input pair is read before its outputs are written, so the
+         * output may be the same memory as the input (interleaved Z with
+         * stride 2).
+         *
+         * @param re real parts of Z
+         * @param im imaginary parts of Z
+         * @param stride distance between consecutive values in re and im
+         * @param w W^k as interleaved values, k = 0..M/2
+         * @param M half of the real transform length
+         * @param out M+1 bins as interleaved values
+         */
+        inline void splitRealSpectrum(const SampleType re[], const SampleType im[],
+                                      std::size_t stride, const SampleType w[],
+                                      std::size_t M, SampleType out[])
+        {
+            const SampleType z0r = re[0], z0i = im[0];
+            out[0] = z0r + z0i;
+            out[1] = 0;
+            out[2 * M] = z0r - z0i;
+            out[2 * M + 1] = 0;
+
+            for (std::size_t k = 1; k <= M / 2; ++k)
+            {
+                const std::size_t j = M - k;
+                const SampleType zkr = re[k * stride], zki = im[k * stride];
+                const SampleType zjr = re[j * stride], zji = im[j * stride];
+                // Fe = (Z[k] + conj(Z[j])) / 2, Fo = -i (Z[k] - conj(Z[j])) / 2
+                const SampleType fer = SampleType(0.5) * (zkr + zjr);
+                const SampleType fei = SampleType(0.5) * (zki - zji);
+                const SampleType for_ = SampleType(0.5) * (zki + zji);
+                const SampleType foi = SampleType(0.5) * (zjr - zkr);
+                const SampleType wr = w[2 * k], wi = w[2 * k + 1];
+                const SampleType tr = wr * for_ - wi * foi;
+                const SampleType ti = wr * foi + wi * for_;
+                // X[k] = Fe + W^k Fo, X[j] = conj(Fe - W^k Fo)
+                out[2 * k] = fer + tr;
+                out[2 * k + 1] = fei + ti;
+                out[2 * j] = fer - tr;
+                out[2 * j + 1] = ti - fei;
+            }
+        }
+
+        /**
+         * Merges the N/2+1 bins of a real spectrum X back into the
+         * spectrum Z of the half-length complex signal, times 2.
+         *
+         * The factors of 1/2 are left to the final scaling of the inverse
+         * transform.
+         *
+         * @param s M+1 bins as interleaved values
+         * @param w W^k as interleaved values, k = 0..M/2
+         * @param M half of the real transform length
+         * @param reversed position of each Z[k] in the output, or nullptr
+         *                 to store Z[k] at k
+         * @param re real parts of Z output
+         * @param im imaginary parts of Z output
+         * @param stride distance between consecutive values in re and im
+         */
+        inline void mergeRealSpectrum(const SampleType s[], const SampleType w[],
+                                      std::size_t M, const std::uint32_t reversed[],
+                                      SampleType re[], SampleType im[], std::size_t stride)
+        {
+            re[0] = s[0] + s[2 * M];
+            im[0] = s[0] - s[2 * M];
+
+            for (std::size_t k = 1; k <= M / 2; ++k)
+            {
+                const std::size_t j = M - k;
+                // Fe = X[k] + conj(X[j]), Fo = (X[k] - conj(X[j])) conj(W^k)
+                const SampleType fer = s[2 * k] + s[2 * j];
+                const SampleType fei = s[2 * k + 1] - s[2 * j + 1];
+                const SampleType dr = s[2 * k] - s[2 * j];
+                const SampleType di = s[2 * k + 1] + s[2 * j + 1];
+                const SampleType wr = w[2 * k], wi = w[2 * k + 1];
+                const SampleType for_ = dr * wr + di * wi;
+                const SampleType foi = di * wr - dr * wi;
+                // Z[k] = Fe + i Fo, Z[j] = conj(Fe) + i conj(Fo)
+                const std::size_t pk = (reversed ? reversed[k] : k) * stride;
+                const std::size_t pj = (reversed ? reversed[j] : j) * stride;
+                re[pk] = fer - foi;
+                im[pk] = fei + for_;
+                re[pj] = fer + foi;
+                im[pj] = for_ - fei;
+            }
+        }
+    }
+}
+
+#endif // REALSPLIT_H
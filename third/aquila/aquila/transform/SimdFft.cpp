@@ -0,0 +1,500 @@
+/**
+ * @file SimdFft.cpp
+ *
+ * Vectorized radix-4 FFT with runtime instruction set selection.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "SimdFft.h"
+#include "SimdFftKernels.h"
+#include "RealSplit.h"
+#include "PlanCache.h"
+#include "../Exceptions.h"
+#include <algorithm>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define AQUILA_SIMDFFT_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace Aquila
+{
+    namespace
+    {
+#ifdef AQUILA_SIMDFFT_SSE2
+        /**
+         * SSE2 lane operations (no fused multiply-add).
+         */
+        struct Sse2Lanes
+        {
+#ifdef AQUILA_SINGLE_PRECISION
+            typedef __m128 Vector;
+            static const std::size_t WIDTH = 4;
+
+            static Vector set1(float x) { return _mm_set1_ps(x); }
+            static Vector load(const float* p) { return _mm_loadu_ps(p); }
+            static void store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+            static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+            static Vector mulAdd(Vector a, Vector b, Vector c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static Vector mulSub(Vector a, Vector b, Vector c) { return _mm_sub_ps(_mm_mul_ps(a, b), c); }
+#else
+            typedef __m128d Vector;
+            static const std::size_t WIDTH = 2;
+
+            static Vector set1(double x) { return _mm_set1_pd(x); }
+            static Vector load(const double* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, Vector v) { _mm_storeu_pd(p, v); }
+            static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+            static Vector mulAdd(Vector a, Vector b, Vector c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+            static Vector mulSub(Vector a, Vector b, Vector c) { return _mm_sub_pd(_mm_mul_pd(a, b), c); }
+#endif
+        };
+#endif
+
+        /**
+         * Whether the processor we run on executes AVX2 and FMA.
+         */
+        bool cpuHasAvx2()
+        {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Number of bits needed to index length values.
+         */
+        std::size_t log2(std::size_t length)
+        {
+            std::size_t bits = 0;
+            while ((std::size_t(1) << bits) < length)
+            {
+                ++bits;
+            }
+            return bits;
+        }
+    }
+
+    /**
+     * Builds the permutation and twiddles of one transform length.
+     *
+     * @param length transform length, a power of 2
+     */
+    SimdFft::Plan::Plan(std::size_t length):
+        length(length), firstLength((log2(length) % 2) ? 2 : 4),
+        reversed(bitReversedIndices(length)),
+        twiddles(radix4Twiddles(length, firstLength))
+    {
+    }
+
+    /**
+     * Builds the tables of both plans and of the real spectrum split.
+     *
+     * @param length transform length, a power of 2
+     */
+    SimdFft::Tables::Tables(std::size_t length):
+        complexPlan(length), halfPlan(length / 2),
+        realTwiddles(realSplitTwiddles(length))
+    {
+    }
+
+    /**
+     * Initializes the transform with the best kernel of this processor.
+     *
+     * @param length input signal size, a power of 2 (at least 4)
+     * @throw ConfigurationException for any other length
+     */
+    SimdFft::SimdFft(std::size_t length):
+        SimdFft(length, Avx2)
+    {
+    }
+
+    /**
+     * Initializes the transform with a chosen kernel.
+     *
+     * A kernel the processor (or the build) does not support is replaced
+     * by the best supported one, so asking for Avx2 is always safe.
+     *
+     * @param length input signal size, a power of 2 (at least 4)
+     * @param instructionSet preferred kernel
+     * @throw ConfigurationException for any other length
+     */
+    SimdFft::SimdFft(std::size_t length, InstructionSet instructionSet):
+        Fft(length),
+        m_instructionSet(std::min(instructionSet, detectInstructionSet())),
+        m_real(length), m_imag(length)
+    {
+        if (length < 4 || (length & (length - 1)) != 0)
+        {
+            throw ConfigurationException(
+                "SimdFft length must be a power of 2, at least 4 (got " +
+                std::to_string(length) + ")");
+        }
+        m_tables = PlanCache<Tables>::get(length);
+    }
+
+    /**
+     * Returns the best kernel supported by this build and processor.
+     *
+     * @return instruction set
+     */
+    SimdFft::InstructionSet SimdFft::detectInstructionSet()
+    {
+        static const InstructionSet detected = [] {
+            if (hasAvx2Kernel() && cpuHasAvx2())
+            {
+                return Avx2;
+            }
+#ifdef AQUILA_SIMDFFT_SSE2
+            return Sse2;
+#else
+            return Scalar;
+#endif
+        }();
+        return detected;
+    }
+
+    /**
+     * Splits interleaved complex values into the work arrays, in bit
+     * reversed order.
+     *
+     * @param plan transform plan
+     * @param in plan.length complex values as interleaved reals
+     */
+    void SimdFft::load(const Plan& plan, const SampleType in[])
+    {
+        const std::uint32_t* reversed = &plan.reversed[0];
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        for (std::size_t i = 0; i < plan.length; ++i)
+        {
+            re[i] = in[2 * reversed[i]];
+            im[i] = in[2 * reversed[i] + 1];
+        }
+    }
+
+    /**
+     * Loads a windowed signal into the work arrays, like load().
+     *
+     * @param plan transform plan
+     * @param in input as interleaved complex values
+     * @param window window coefficients, one per input value
+     */
+    void SimdFft::loadWindowed(const Plan& plan, const SampleType in[],
+                               const SampleType window[])
+    {
+        const std::uint32_t* reversed = &plan.reversed[0];
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        for (std::size_t i = 0; i < plan.length; ++i)
+        {
+            const std::size_t n = 2 * reversed[i];
+            re[i] = in[n] * window[n];
+            im[i] = in[n + 1] * window[n + 1];
+        }
+    }
+
+    /**
+     * Runs the transform on loaded data, in place and without scaling.
+     *
+     * The first pass needs no twiddles and is done here, the radix-4
+     * passes by the selected kernel.
+     *
+     * @param plan transform plan
+     * @param inverse whether to use conjugated twiddles
+     */
+    void SimdFft::transform(const Plan& plan, bool inverse)
+    {
+        const std::size_t M = plan.length;
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+        if (plan.firstLength == 2)
+        {
+            for (std::size_t j = 0; j < M; j += 2)
+            {
+                const SampleType r0 = re[j], i0 = im[j];
+                const SampleType r1 = re[j + 1], i1 = im[j + 1];
+                re[j] = r0 + r1;
+                im[j] = i0 + i1;
+                re[j + 1] = r0 - r1;
+                im[j + 1] = i0 - i1;
+            }
+        }
+        else
+        {
+            // multiplication by -i (forward) or +i (inverse)
+            const SampleType rot = inverse ? 1 : -1;
+            for (std::size_t j = 0; j < M; j += 4)
+            {
+                const SampleType er0 = re[j] + re[j + 1], ei0 = im[j] + im[j + 1];
+                const SampleType er1 = re[j] - re[j + 1], ei1 = im[j] - im[j + 1];
+                const SampleType or0 = re[j + 2] + re[j + 3], oi0 = im[j + 2] + im[j + 3];
+                const SampleType or1 = re[j + 2] - re[j + 3], oi1 = im[j + 2] - im[j + 3];
+                re[j] = er0 + or0;
+                im[j] = ei0 + oi0;
+                re[j + 2] = er0 - or0;
+                im[j + 2] = ei0 - oi0;
+                re[j + 1] = er1 - rot * oi1;
+                im[j + 1] = ei1 + rot * or1;
+                re[j + 3] = er1 + rot * oi1;
+                im[j + 3] = ei1 - rot * or1;
+            }
+        }
+
+        if (plan.twiddles.empty())
+        {
+            return;
+        }
+        const SampleType* w = &plan.twiddles[0];
+        switch (m_instructionSet)
+        {
+        case Avx2:
+            radix4PassesAvx2(re, im, w, M, plan.firstLength, inverse);
+            break;
+#ifdef AQUILA_SIMDFFT_SSE2
+        case Sse2:
+            radix4Passes<Sse2Lanes>(re, im, w, M, plan.firstLength, inverse);
+            break;
+#endif
+        default:
+            radix4Passes<ScalarLanes>(re, im, w, M, plan.firstLength, inverse);
+            break;
+        }
+    }
+
+    /**
+     * Applies the transformation to the signal.
+     *
+     * Computes the real transform and fills the upper half of the spectrum
+     * by conjugate symmetry.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N bins)
+     */
+    void SimdFft::fft(const SampleType x[], ComplexType spectrum[])
+    {
+        rfft(x, spectrum);
+        for (std::size_t k = N / 2 + 1; k < N; ++k)
+        {
+            spectrum[k] = std::conj(spectrum[N - k]);
+        }
+    }
+
+    /**
+     * Applies the inverse transform to the spectrum.
+     *
+     * @param spectrum input spectrum (N bins)
+     * @param x output signal
+     */
+    void SimdFft::ifft(const ComplexType spectrum[], SampleType x[])
+    {
+        load(m_tables->complexPlan, reinterpret_cast<const SampleType*>(spectrum));
+        transform(m_tables->complexPlan, true);
+        const SampleType scale = SampleType(1) / N;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            x[i] = m_real[i] * scale;
+        }
+    }
+
+    /**
+     * Applies the real-input transformation to the signal.
+     *
+     * The even and odd samples are treated as real and imaginary parts of
+     * a complex signal of length N/2, which is transformed and then split
+     * into N/2+1 bins.
+     *
+     * @param x input signal
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void SimdFft::rfft(const SampleType x[], ComplexType spectrum[])
+    {
+        load(m_tables->halfPlan, x);
+        transform(m_tables->halfPlan, false);
+
+        split(&m_real[0], &m_imag[0], 1, spectrum);
+    }
+
+    /**
+     * Applies the real-input transformation to a windowed signal.
+     *
+     * The window is applied while the samples are loaded in bit reversed
+     * order.
+     *
+     * @param x input signal
+     * @param window window coefficients
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void SimdFft::rfftWindowed(const SampleType x[], const SampleType window[],
+                               ComplexType spectrum[])
+    {
+        loadWindowed(m_tables->halfPlan, x, window);
+        transform(m_tables->halfPlan, false);
+
+        split(&m_real[0], &m_imag[0], 1, spectrum);
+    }
+
+    /**
+     * Applies the real-input transformation to a batch of signals.
+     *
+     * Signals are loaded eight at a time, value n of signal b at index
+     * 8n + b, and transformed together by the batched kernel. A partial
+     * last batch repeats its last signal in the unused slots.
+     *
+     * Allocates its scratch on the first call.
+     *
+     * @param x pointers to count input signals
+     * @param count number of signals
+     * @param spectra output spectra (count * (N/2+1) bins)
+     */
+    void SimdFft::rfftBatch(const SampleType* const x[], std::size_t count,
+                            ComplexType spectra[])
+    {
+        const std::size_t M = N / 2;
+        const Plan& plan = m_tables->halfPlan;
+        if (m_batchReal.empty())
+        {
+            m_batchReal.resize(M * BATCH);
+            m_batchImag.resize(M * BATCH);
+        }
+        SampleType* re = &m_batchReal[0];
+        SampleType* im = &m_batchImag[0];
+        const std::uint32_t* reversed = &plan.reversed[0];
+
+        for (std::size_t first = 0; first < count; first += BATCH)
+        {
+            const std::size_t signals = std::min(BATCH, count - first);
+            const SampleType* in[BATCH];
+            for (std::size_t b = 0; b < BATCH; ++b)
+            {
+                in[b] = x[first + std::min(b, signals - 1)];
+            }
+            for (std::size_t k = 0; k < M; ++k)
+            {
+                const std::size_t n = 2 * reversed[k];
+                for (std::size_t b = 0; b < BATCH; ++b)
+                {
+                    re[k * BATCH + b] = in[b][n];
+                    im[k * BATCH + b] = in[b][n + 1];
+                }
+            }
+
+            switch (m_instructionSet)
+            {
+            case Avx2:
+                batchTransformAvx2(re, im, plan.twiddles.data(), M, plan.firstLength);
+                break;
+#ifdef AQUILA_SIMDFFT_SSE2
+            case Sse2:
+                batchTransform<Sse2Lanes, false>(re, im, plan.twiddles.data(), M, plan.firstLength);
+                break;
+#endif
+            default:
+                batchTransform<ScalarLanes, false>(re, im, plan.twiddles.data(), M, plan.firstLength);
+                break;
+            }
+
+            for (std::size_t b = 0; b < signals; ++b)
+            {
+                split(re + b, im + b, BATCH, spectra + (first + b) * (M + 1));
+            }
+        }
+    }
+
+    /**
+     * Splits the half-length complex spectrum into a real one.
+     *
+     * @param re real parts of the N/2 complex spectrum
+     * @param im imaginary parts of the N/2 complex spectrum
+     * @param stride distance between consecutive values in re and im
+     * @param spectrum output spectrum (N/2+1 bins)
+     */
+    void SimdFft::split(const SampleType re[], const SampleType im[],
+                        std::size_t stride, ComplexType spectrum[]) const
+    {
+        splitRealSpectrum(re, im, stride, &m_tables->realTwiddles[0], N / 2,
+                          reinterpret_cast<SampleType*>(spectrum));
+    }
+
+    /**
+     * Applies the inverse real transform to a half spectrum.
+     *
+     * Reverses the split done by rfft(), storing the complex signal of
+     * length N/2 directly in bit reversed order, and transforms it.
+     *
+     * @param spectrum first N/2+1 bins of a conjugate-symmetric spectrum
+     * @param x output signal
+     */
+    void SimdFft::irfft(const ComplexType spectrum[], SampleType x[])
+    {
+        const std::size_t M = N / 2;
+        const SampleType* s = reinterpret_cast<const SampleType*>(spectrum);
+        const std::uint32_t* reversed = &m_tables->halfPlan.reversed[0];
+        SampleType* re = &m_real[0];
+        SampleType* im = &m_imag[0];
+
+        // the factors of 1/2 are folded into the final scaling
+        mergeRealSpectrum(s, &m_tables->realTwiddles[0], M, reversed, re, im, 1);
+
+        transform(m_tables->halfPlan, true);
+        const SampleType scale = SampleType(1) / N;
+        for (std::size_t i = 0; i < M; ++i)
+        {
+            x[2 * i] = re[i] * scale;
+            x[2 * i + 1] = im[i] * scale;
+        }
+    }
+
+    /**
+     * Applies the transformation in place.
+     *
+     * @param data complex signal on input, its spectrum on output
+     */
+    void SimdFft::fftInPlace(ComplexType data[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        load(m_tables->complexPlan, a);
+        transform(m_tables->complexPlan, false);
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            a[2 * i] = m_real[i];
+            a[2 * i + 1] = m_imag[i];
+        }
+    }
+
+    /**
+     * Applies the inverse transformation in place.
+     *
+     * @param data spectrum on input, complex signal on output
+     */
+    void SimdFft::ifftInPlace(ComplexType data[])
+    {
+        SampleType* a = reinterpret_cast<SampleType*>(data);
+        load(m_tables->complexPlan, a);
+        transform(m_tables->complexPlan, true);
+        const SampleType scale = SampleType(1) / N;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            a[2 * i] = m_real[i] * scale;
+            a[2 * i + 1] = m_imag[i] * scale;
+        }
+    }
+}
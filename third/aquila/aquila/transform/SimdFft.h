@@ -0,0 +1,182 @@
+/**
+ * @file SimdFft.h
+ *
+ * Vectorized radix-4 FFT with runtime instruction set selection.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef SIMDFFT_H
+#define SIMDFFT_H
+
+#include "Fft.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Aquila
+{
+    /**
+     * A vectorized FFT for any power of 2 length.
+     *
+     * The algorithm is the same iterative radix-4 decimation in time as
+     * in FixedFft (real and imaginary parts in separate arrays, a leading
+     * radix-2 pass for odd powers of 2, half-length complex FFT for real
+     * input), but the length is chosen at runtime and the butterflies are
+     * written with explicit vector operations.
+     *
+     * Three kernels exist: AVX2 with fused multiply-add, SSE2 and plain
+     * scalar code. The best one supported by the processor is picked
+     * when the object is created, so a single library binary runs on
+     * any x86 machine and still uses AVX2 where it is available. Other
+     * architectures use the scalar kernel.
+     *
+     * rfftBatch() transforms eight signals at a time with the values of
+     * all eight interleaved, so each butterfly vector spans signals and
+     * shares one twiddle factor.
+     */
+    class AQUILA_EXPORT SimdFft : public Fft
+    {
+    public:
+        /**
+         * Butterfly kernel variants, from the most portable.
+         */
+        enum InstructionSet {Scalar, Sse2, Avx2};
+
+        SimdFft(std::size_t length);
+        SimdFft(std::size_t length, InstructionSet instructionSet);
+
+        static InstructionSet detectInstructionSet();
+
+        /**
+         * Returns the kernel used by this object.
+         *
+         * @return instruction set
+         */
+        InstructionSet getInstructionSet() const
+        {
+            return m_instructionSet;
+        }
+
+        using Fft::fft;
+        using Fft::ifft;
+        using Fft::rfft;
+        using Fft::irfft;
+
+        virtual void fft(const SampleType x[], ComplexType spectrum[]);
+        virtual void ifft(const ComplexType spectrum[], SampleType x[]);
+        virtual void rfft(const SampleType x[], ComplexType spectrum[]);
+        virtual void rfftWindowed(const SampleType x[], const SampleType window[],
+                                  ComplexType spectrum[]);
+        virtual void irfft(const ComplexType spectrum[], SampleType x[]);
+        virtual void fftInPlace(ComplexType data[]);
+        virtual void ifftInPlace(ComplexType data[]);
+        virtual void rfftBatch(const SampleType* const x[], std::size_t count,
+                               ComplexType spectra[]);
+
+    private:
+        /**
+         * Permutation and twiddles of a complex transform of one length.
+         */
+        struct Plan
+        {
+            Plan(std::size_t length);
+
+            /**
+             * Transform length.
+             */
+            std::size_t length;
+
+            /**
+             * Sub-transform length after the twiddle-free first pass.
+             */
+            std::size_t firstLength;
+
+            /**
+             * Bit reversed index of each position.
+             */
+            std::vector<std::uint32_t> reversed;
+
+            /**
+             * Twiddles of all radix-4 passes, in order.
+             */
+            std::vector<SampleType> twiddles;
+        };
+
+        /**
+         * All tables of one transform length, shared by every object of
+         * that length (see PlanCache).
+         */
+        struct Tables
+        {
+            Tables(std::size_t length);
+
+            /**
+             * Plan of the complex transforms.
+             */
+            Plan complexPlan;
+
+            /**
+             * Plan of the half-length transform used for real input.
+             */
+            Plan halfPlan;
+
+            /**
+             * Twiddles W^k for k = 0..N/4, interleaved, used to split the
+             * half-length spectrum.
+             */
+            std::vector<SampleType> realTwiddles;
+        };
+
+        void load(const Plan& plan, const SampleType in[]);
+        void loadWindowed(const Plan& plan, const SampleType in[],
+                          const SampleType window[]);
+        void transform(const Plan& plan, bool inverse);
+        void split(const SampleType re[], const SampleType im[],
+                   std::size_t stride, ComplexType spectrum[]) const;
+
+        /**
+         * Butterfly kernel used by this object.
+         */
+        InstructionSet m_instructionSet;
+
+        /**
+         * Shared tables of this length.
+         */
+        std::shared_ptr<const Tables> m_tables;
+
+        /**
+         * Real parts of the signal being transformed.
+         */
+        std::vector<SampleType> m_real;
+
+        /**
+         * Imaginary parts of the signal being transformed.
+         */
+        std::vector<SampleType> m_imag;
+
+        /**
+         * Real parts of a batch of signals, interleaved by signal.
+         *
+         * Allocated by the first rfftBatch() call.
+         */
+        std::vector<SampleType> m_batchReal;
+
+        /**
+         * Imaginary parts of a batch of signals, interleaved by signal.
+         */
+        std::vector<SampleType> m_batchImag;
+    };
+}
+
+#endif // SIMDFFT_H
@@ -0,0 +1,108 @@
+/**
+ * @file SimdFftAvx2.cpp
+ *
+ * AVX2/FMA variant of the SimdFft butterfly passes.
+ *
+ * The build compiles this file (and only this file) with AVX2 and FMA
+ * code generation enabled; SimdFft calls into it only after checking
+ * the processor at runtime.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#include "SimdFftKernels.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#  include <immintrin.h>
+#endif
+
+namespace Aquila
+{
+#if defined(__AVX2__) && defined(__FMA__)
+
+    namespace
+    {
+        /**
+         * AVX lane operations, fused multiply-add included.
+         */
+        struct Avx2Lanes
+        {
+#ifdef AQUILA_SINGLE_PRECISION
+            typedef __m256 Vector;
+            static const std::size_t WIDTH = 8;
+
+            static Vector set1(float x) { return _mm256_set1_ps(x); }
+            static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+            static void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+            static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+            static Vector mulAdd(Vector a, Vector b, Vector c) { return _mm256_fmadd_ps(a, b, c); }
+            static Vector mulSub(Vector a, Vector b, Vector c) { return _mm256_fmsub_ps(a, b, c); }
+#else
+            typedef __m256d Vector;
+            static const std::size_t WIDTH = 4;
+
+            static Vector set1(double x) { return _mm256_set1_pd(x); }
+            static Vector load(const double* p) { return _mm256_loadu_pd(p); }
+            static void store(double* p, Vector v) { _mm256_storeu_pd(p, v); }
+            static Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+            static Vector mulAdd(Vector a, Vector b, Vector c) { return _mm256_fmadd_pd(a, b, c); }
+            static Vector mulSub(Vector a, Vector b, Vector c) { return _mm256_fmsub_pd(a, b, c); }
+#endif
+        };
+    }
+
+    void radix4PassesAvx2(SampleType re[], SampleType im[],
+                          const SampleType twiddles[], std::size_t length,
+                          std::size_t firstLength, bool inverse)
+    {
+        radix4Passes<Avx2Lanes>(re, im, twiddles, length, firstLength, inverse);
+    }
+
+    bool hasAvx2Kernel()
+    {
+        return true;
+    }
+
+    void batchTransformAvx2(SampleType re[], SampleType im[],
+                            const SampleType twiddles[], std::size_t length,
+                            std::size_t firstLength)
+    {
+        batchTransform<Avx2Lanes, false>(re, im, twiddles, length, firstLength);
+    }
+
+#else
+
+    void radix4PassesAvx2(SampleType re[], SampleType im[],
+                          const SampleType twiddles[], std::size_t length,
+                          std::size_t firstLength, bool inverse)
+    {
+        radix4Passes<ScalarLanes>(re, im, twiddles, length, firstLength, inverse);
+    }
+
+    bool hasAvx2Kernel()
+    {
+        return false;
+    }
+
+    void batchTransformAvx2(SampleType re[], SampleType im[],
+                            const SampleType twiddles[], std::size_t length,
+                            std::size_t firstLength)
+    {
+        batchTransform<ScalarLanes, false>(re, im, twiddles, length, firstLength);
+    }
+
+#endif
+}
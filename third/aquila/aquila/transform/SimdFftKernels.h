@@ -0,0 +1,308 @@
+/**
+ * @file SimdFftKernels.h
+ *
+ * Radix-4 butterfly passes shared by the instruction set variants of
+ * SimdFft. Internal header, not a part of the public interface.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef SIMDFFTKERNELS_H
+#define SIMDFFTKERNELS_H
+
+#include "../global.h"
+#include <cstddef>
+
+namespace Aquila
+{
+    /**
+     * Runs all radix-4 passes of a transform with the AVX2/FMA kernel.
+     *
+     * Defined in SimdFftAvx2.cpp, which is the only file compiled with
+     * AVX2 code generation enabled. Must only be called when both
+     * hasAvx2Kernel() and the processor say so.
+     *
+     * @param re real parts of length values, after the first pass
+     * @param im imaginary parts of length values, after the first pass
+     * @param twiddles twiddles of all passes, in order
+     * @param length transform length
+     * @param firstLength sub-transform length after the first pass
+     * @param inverse whether to use conjugated twiddles
+     */
+    void radix4PassesAvx2(SampleType re[], SampleType im[],
+                          const SampleType twiddles[], std::size_t length,
+                          std::size_t firstLength, bool inverse);
+
+    /**
+     * Whether the library was built with the AVX2/FMA kernel.
+     *
+     * @return false when the compiler could not target AVX2
+     */
+    bool hasAvx2Kernel();
+
+    /**
+     * Forward batched transform with the AVX2/FMA kernel, see
+     * batchTransform() below.
+     */
+    void batchTransformAvx2(SampleType re[], SampleType im[],
+                            const SampleType twiddles[], std::size_t length,
+                            std::size_t firstLength);
+
+    // Everything below has internal linkage on purpose: each translation
+    // unit gets its own copy compiled for its own instruction set, so the
+    // linker can never pick an AVX2 instantiation for the portable code.
+    namespace
+    {
+        /**
+         * Lane operations of a one element "vector", used for the scalar
+         * kernel and for passes shorter than the vector width.
+         */
+        struct ScalarLanes
+        {
+            typedef SampleType Vector;
+            static const std::size_t WIDTH = 1;
+
+            static Vector set1(SampleType x) { return x; }
+            static Vector load(const SampleType* p) { return *p; }
+            static void store(SampleType* p, Vector v) { *p = v; }
+            static Vector add(Vector a, Vector b) { return a + b; }
+            static Vector sub(Vector a, Vector b) { return a - b; }
+            static Vector mul(Vector a, Vector b) { return a * b; }
+            static Vector mulAdd(Vector a, Vector b, Vector c) { return a * b + c; }
+            static Vector mulSub(Vector a, Vector b, Vector c) { return a * b - c; }
+        };
+
+        /**
+         * Multiplies x by the twiddle w, or by its conjugate for the
+         * inverse transform.
+         */
+        template <class Lanes, bool Inverse>
+        inline void twiddleMultiply(typename Lanes::Vector wr, typename Lanes::Vector wi,
+                                    typename Lanes::Vector xr, typename Lanes::Vector xi,
+                                    typename Lanes::Vector& yr, typename Lanes::Vector& yi)
+        {
+            if (Inverse)
+            {
+                yr = Lanes::mulAdd(wr, xr, Lanes::mul(wi, xi));
+                yi = Lanes::mulSub(wr, xi, Lanes::mul(wi, xr));
+            }
+            else
+            {
+                yr = Lanes::mulSub(wr, xr, Lanes::mul(wi, xi));
+                yi = Lanes::mulAdd(wr, xi, Lanes::mul(wi, xr));
+            }
+        }
+
+        /**
+         * One vector of radix-4 butterflies.
+         *
+         * Two fused radix-2 stages: the quarters are first combined in
+         * pairs with W^2k, then the pair results with W^k. The
+         * multiplication by -i (forward) or +i (inverse) between them is
+         * a swap of components with one sign change.
+         *
+         * @param r real parts of the four quarters
+         * @param i imaginary parts of the four quarters
+         */
+        template <class Lanes, bool Inverse>
+        inline void radix4Butterfly(SampleType* const r[4], SampleType* const i[4],
+                                    typename Lanes::Vector w1r, typename Lanes::Vector w1i,
+                                    typename Lanes::Vector w2r, typename Lanes::Vector w2i)
+        {
+            typedef typename Lanes::Vector Vector;
+            Vector br, bi, dr, di;
+            twiddleMultiply<Lanes, Inverse>(w2r, w2i, Lanes::load(r[1]), Lanes::load(i[1]), br, bi);
+            twiddleMultiply<Lanes, Inverse>(w2r, w2i, Lanes::load(r[3]), Lanes::load(i[3]), dr, di);
+            const Vector ar = Lanes::load(r[0]), ai = Lanes::load(i[0]);
+            const Vector cr = Lanes::load(r[2]), ci = Lanes::load(i[2]);
+            const Vector e0r = Lanes::add(ar, br), e0i = Lanes::add(ai, bi);
+            const Vector e1r = Lanes::sub(ar, br), e1i = Lanes::sub(ai, bi);
+
+            Vector t0r, t0i, t1r, t1i;
+            twiddleMultiply<Lanes, Inverse>(w1r, w1i, Lanes::add(cr, dr), Lanes::add(ci, di), t0r, t0i);
+            twiddleMultiply<Lanes, Inverse>(w1r, w1i, Lanes::sub(cr, dr), Lanes::sub(ci, di), t1r, t1i);
+
+            Lanes::store(r[0], Lanes::add(e0r, t0r));
+            Lanes::store(i[0], Lanes::add(e0i, t0i));
+            Lanes::store(r[2], Lanes::sub(e0r, t0r));
+            Lanes::store(i[2], Lanes::sub(e0i, t0i));
+            if (Inverse)
+            {
+                Lanes::store(r[1], Lanes::sub(e1r, t1i));
+                Lanes::store(i[1], Lanes::add(e1i, t1r));
+                Lanes::store(r[3], Lanes::add(e1r, t1i));
+                Lanes::store(i[3], Lanes::sub(e1i, t1r));
+            }
+            else
+            {
+                Lanes::store(r[1], Lanes::add(e1r, t1i));
+                Lanes::store(i[1], Lanes::sub(e1i, t1r));
+                Lanes::store(r[3], Lanes::sub(e1r, t1i));
+                Lanes::store(i[3], Lanes::add(e1i, t1r));
+            }
+        }
+
+        /**
+         * Butterflies of one block of 4*L values, Lanes::WIDTH at a time.
+         *
+         * @param re real parts of the block
+         * @param im imaginary parts of the block
+         * @param w pass twiddles: runs of L values of Re W^k, Im W^k,
+         *          Re W^2k and Im W^2k
+         * @param L sub-transform length, a multiple of Lanes::WIDTH
+         */
+        template <class Lanes, bool Inverse>
+        void radix4Block(SampleType* AQUILA_RESTRICT re, SampleType* AQUILA_RESTRICT im,
+                         const SampleType* AQUILA_RESTRICT w, std::size_t L)
+        {
+            for (std::size_t k = 0; k < L; k += Lanes::WIDTH)
+            {
+                SampleType* const r[4] = {re + k, re + L + k, re + 2 * L + k, re + 3 * L + k};
+                SampleType* const i[4] = {im + k, im + L + k, im + 2 * L + k, im + 3 * L + k};
+                radix4Butterfly<Lanes, Inverse>(r, i,
+                    Lanes::load(w + k), Lanes::load(w + L + k),
+                    Lanes::load(w + 2 * L + k), Lanes::load(w + 3 * L + k));
+            }
+        }
+
+        /**
+         * Runs all radix-4 passes following the twiddle-free first pass.
+         *
+         * Passes shorter than the vector width use the scalar lanes.
+         */
+        template <class Lanes, bool Inverse>
+        void radix4Passes(SampleType re[], SampleType im[], const SampleType twiddles[],
+                          std::size_t length, std::size_t firstLength)
+        {
+            const SampleType* w = twiddles;
+            for (std::size_t L = firstLength; 4 * L <= length; L *= 4)
+            {
+                for (std::size_t j = 0; j < length; j += 4 * L)
+                {
+                    if (L >= Lanes::WIDTH)
+                    {
+                        radix4Block<Lanes, Inverse>(re + j, im + j, w, L);
+                    }
+                    else
+                    {
+                        radix4Block<ScalarLanes, Inverse>(re + j, im + j, w, L);
+                    }
+                }
+                w += 4 * L;
+            }
+        }
+
+        /**
+         * Runtime inverse flag to template argument.
+         */
+        template <class Lanes>
+        void radix4Passes(SampleType re[], SampleType im[], const SampleType twiddles[],
+                          std::size_t length, std::size_t firstLength, bool inverse)
+        {
+            if (inverse)
+            {
+                radix4Passes<Lanes, true>(re, im, twiddles, length, firstLength);
+            }
+            else
+            {
+                radix4Passes<Lanes, false>(re, im, twiddles, length, firstLength);
+            }
+        }
+
+        /**
+         * Number of frames transformed together by the batched kernels.
+         *
+         * A multiple of every vector width in use.
+         */
+        const std::size_t BATCH = 8;
+
+        /**
+         * Complete transform of BATCH signals at once.
+         *
+         * Value n of signal b is stored at index n * BATCH + b, so every
+         * butterfly works on BATCH consecutive values sharing one
+         * (broadcast) twiddle. Unlike the single transform, even the
+         * first passes, shorter than a vector, run on full vectors.
+         *
+         * @param re real parts, in bit reversed order of positions
+         * @param im imaginary parts, in bit reversed order of positions
+         * @param twiddles twiddles of all radix-4 passes, in order
+         * @param length transform length
+         * @param firstLength 2 or 4, see SimdFft::Plan
+         */
+        template <class Lanes, bool Inverse>
+        void batchTransform(SampleType* AQUILA_RESTRICT re, SampleType* AQUILA_RESTRICT im,
+                            const SampleType twiddles[], std::size_t length,
+                            std::size_t firstLength)
+        {
+            typedef typename Lanes::Vector Vector;
+            if (firstLength == 2)
+            {
+                for (std::size_t j = 0; j < length * BATCH; j += 2 * BATCH)
+                {
+                    for (std::size_t b = 0; b < BATCH; b += Lanes::WIDTH)
+                    {
+                        const Vector r0 = Lanes::load(re + j + b), i0 = Lanes::load(im + j + b);
+                        const Vector r1 = Lanes::load(re + j + BATCH + b), i1 = Lanes::load(im + j + BATCH + b);
+                        Lanes::store(re + j + b, Lanes::add(r0, r1));
+                        Lanes::store(im + j + b, Lanes::add(i0, i1));
+                        Lanes::store(re + j + BATCH + b, Lanes::sub(r0, r1));
+                        Lanes::store(im + j + BATCH + b, Lanes::sub(i0, i1));
+                    }
+                }
+            }
+            else
+            {
+                // a radix-4 pass of sub-transforms of length 1, W^0 = 1
+                const Vector one = Lanes::set1(1), zero = Lanes::set1(0);
+                for (std::size_t j = 0; j < length * BATCH; j += 4 * BATCH)
+                {
+                    for (std::size_t b = 0; b < BATCH; b += Lanes::WIDTH)
+                    {
+                        SampleType* const r[4] = {re + j + b, re + j + BATCH + b,
+                                                  re + j + 2 * BATCH + b, re + j + 3 * BATCH + b};
+                        SampleType* const i[4] = {im + j + b, im + j + BATCH + b,
+                                                  im + j + 2 * BATCH + b, im + j + 3 * BATCH + b};
+                        radix4Butterfly<Lanes, Inverse>(r, i, one, zero, one, zero);
+                    }
+                }
+            }
+
+            const SampleType* w = twiddles;
+            for (std::size_t L = firstLength; 4 * L <= length; L *= 4)
+            {
+                const std::size_t quarter = L * BATCH;
+                for (std::size_t j = 0; j < length * BATCH; j += 4 * quarter)
+                {
+                    for (std::size_t k = 0; k < L; ++k)
+                    {
+                        const Vector w1r = Lanes::set1(w[k]), w1i = Lanes::set1(w[L + k]);
+                        const Vector w2r = Lanes::set1(w[2 * L + k]), w2i = Lanes::set1(w[3 * L + k]);
+                        SampleType* rk = re + j + k * BATCH;
+                        SampleType* ik = im + j + k * BATCH;
+                        for (std::size_t b = 0; b < BATCH; b += Lanes::WIDTH)
+                        {
+                            SampleType* const r[4] = {rk + b, rk + quarter + b,
+                                                      rk + 2 * quarter + b, rk + 3 * quarter + b};
+                            SampleType* const i[4] = {ik + b, ik + quarter + b,
+                                                      ik + 2 * quarter + b, ik + 3 * quarter + b};
+                            radix4Butterfly<Lanes, Inverse>(r, i, w1r, w1i, w2r, w2i);
+                        }
+                    }
+                }
+                w += 4 * L;
+            }
+        }
+    }
+}
+
+#endif // SIMDFFTKERNELS_H
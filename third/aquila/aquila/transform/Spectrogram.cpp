@@ -17,28 +17,77 @@
 
 #include "Spectrogram.h"
 #include "FftFactory.h"
-#include "../source/Frame.h"
+#include "ParallelSpectrogram.h"
 #include "../source/FramesCollection.h"
+#include "../source/FrameView.h"
+#include <vector>
 
 namespace Aquila
 {
     /**
      * Creates the spectrogram from a collection of signal frames.
      *
-     * Calculates frame spectra immediately after initialization.
-     *
      * @param frames input frames
      */
     Spectrogram::Spectrogram(FramesCollection& frames):
+        Spectrogram(frames.views())
+    {
+    }
+
+    /**
+     * Creates the spectrogram from a collection using several threads.
+     *
+     * @param frames input frames
+     * @param threadCount number of worker threads, 0 for one per core
+     */
+    Spectrogram::Spectrogram(FramesCollection& frames, std::size_t threadCount):
+        Spectrogram(frames.views(), threadCount)
+    {
+    }
+
+    /**
+     * Creates the spectrogram from frame views.
+     *
+     * Calculates frame spectra immediately after initialization. As the
+     * frames are real signals, only N/2+1 bins of each spectrum are
+     * calculated and stored. All frames are passed to the FFT as a
+     * single batch.
+     *
+     * @param frames input frames
+     */
+    Spectrogram::Spectrogram(const FrameViewRange& frames):
         m_frameCount(frames.count()),
         m_spectrumSize(frames.getSamplesPerFrame()),
         m_fft(FftFactory::getFft(m_spectrumSize)),
-        m_data(new SpectrogramDataType(m_frameCount))
+        m_data(new SpectrumType(m_frameCount * (m_spectrumSize / 2 + 1)))
     {
-        std::size_t i = 0;
-        for (auto it = frames.begin(); it != frames.end(); ++it, ++i)
+        if (0 == m_frameCount)
+        {
+            return;
+        }
+        std::vector<const SampleType*> inputs;
+        inputs.reserve(m_frameCount);
+        for (auto it = frames.begin(); it != frames.end(); ++it)
         {
-            (*m_data)[i] = m_fft->fft(it->toArray());
+            inputs.push_back((*it).toArray());
         }
+        m_fft->rfftBatch(&inputs[0], m_frameCount, &(*m_data)[0]);
+    }
+
+    /**
+     * Creates the spectrogram from frame views using several threads.
+     *
+     * The result is the same as with a single thread, see
+     * ParallelSpectrogram.
+     *
+     * @param frames input frames
+     * @param threadCount number of worker threads, 0 for one per core
+     */
+    Spectrogram::Spectrogram(const FrameViewRange& frames, std::size_t threadCount):
+        m_frameCount(frames.count()),
+        m_spectrumSize(frames.getSamplesPerFrame()),
+        m_fft(),
+        m_data(ParallelSpectrogram(frames, threadCount).getData())
+    {
     }
 }
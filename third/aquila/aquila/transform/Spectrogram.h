@@ -19,6 +19,7 @@
 #define SPECTROGRAM_H
 
 #include "../global.h"
+#include <complex>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -27,6 +28,7 @@
 namespace Aquila
 {
     class Fft;
+    class FrameViewRange;
     class FramesCollection;
 
     /**
@@ -38,6 +40,9 @@ namespace Aquila
     {
     public:
         Spectrogram(FramesCollection& frames);
+        Spectrogram(FramesCollection& frames, std::size_t threadCount);
+        Spectrogram(const FrameViewRange& frames);
+        Spectrogram(const FrameViewRange& frames, std::size_t threadCount);
 
         /**
          * Returns number of frames (spectrogram width).
@@ -68,15 +73,29 @@ namespace Aquila
          */
         ComplexType getPoint(std::size_t frame, std::size_t peak) const
         {
-            return (*m_data)[frame][peak];
+            // only the non-redundant half of each spectrum is stored,
+            // the upper half is the complex conjugate mirror of it
+            if (peak > m_spectrumSize / 2)
+            {
+                return std::conj(getSpectrum(frame)[m_spectrumSize - peak]);
+            }
+            return getSpectrum(frame)[peak];
         }
 
-    private:
         /**
-         * Spectrogram data type used for internal storage.
+         * Returns the stored half spectrum of a frame.
+         *
+         * Spectra of consecutive frames are contiguous in memory.
+         *
+         * @param frame frame number
+         * @return pointer to N/2+1 spectrum bins
          */
-        typedef std::vector<SpectrumType> SpectrogramDataType;
+        const ComplexType* getSpectrum(std::size_t frame) const
+        {
+            return &(*m_data)[frame * (m_spectrumSize / 2 + 1)];
+        }
 
+    private:
         /**
          * Frame count (width of the spectrogram).
          */
@@ -93,9 +112,9 @@ namespace Aquila
         std::shared_ptr<Fft> m_fft;
 
         /**
-         * A shared pointer to spectrogram data.
+         * A shared pointer to spectrogram data, all spectra in one array.
          */
-        std::shared_ptr<SpectrogramDataType> m_data;
+        std::shared_ptr<SpectrumType> m_data;
     };
 }
 
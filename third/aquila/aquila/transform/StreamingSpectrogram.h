@@ -0,0 +1,457 @@
+/**
+ * @file StreamingSpectrogram.h
+ *
+ * Spectrogram of an unbounded stream of frames, kept in fixed memory.
+ *
+ * This file is part of the Aquila DSP library.
+ * Aquila is free software, licensed under the MIT/X11 License. A copy of
+ * the license is provided with the library in the LICENSE file.
+ *
+ * @package Aquila
+ * @version 3.0.0-dev
+ * @author Zbigniew Siciarz
+ * @date 2007-2014
+ * @license http://www.opensource.org/licenses/mit-license.php MIT
+ * @since 3.0.0
+ */
+
+#ifndef STREAMINGSPECTROGRAM_H
+#define STREAMINGSPECTROGRAM_H
+
+#include "../global.h"
+#include "../functions.h"
+#include "../Exceptions.h"
+#include "../source/FramesCollection.h"
+#include "../source/FrameView.h"
+#include "Fft.h"
+#include "FftFactory.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Aquila
+{
+    /**
+     * Stores spectrum bins as they are.
+     */
+    class ComplexStorage
+    {
+    public:
+        /**
+         * Type of a stored bin.
+         */
+        typedef ComplexType StoredType;
+
+        /**
+         * Type of a bin value read back.
+         */
+        typedef ComplexType ValueType;
+
+        StoredType store(ComplexType bin) const
+        {
+            return bin;
+        }
+
+        ValueType load(StoredType stored) const
+        {
+            return stored;
+        }
+    };
+
+    /**
+     * Stores bin magnitudes in single precision.
+     */
+    class MagnitudeStorage
+    {
+    public:
+        typedef float StoredType;
+        typedef double ValueType;
+
+        StoredType store(ComplexType bin) const
+        {
+            return static_cast<float>(std::abs(bin));
+        }
+
+        ValueType load(StoredType stored) const
+        {
+            return stored;
+        }
+    };
+
+    /**
+     * Stores bin magnitudes in dB, quantized to an unsigned integer type.
+     *
+     * Levels between floor and ceiling are mapped linearly onto the whole
+     * range of Code, so 8 bits over a 96 dB range give about 0.4 dB steps
+     * and 16 bits give about 0.0015 dB. Levels outside the range are
+     * clamped to it (silence is stored as the floor). Levels are those of
+     * the unnormalized FFT output, so the range depends on the sample
+     * scale and the frame length.
+     */
+    template <typename Code>
+    class DecibelStorage
+    {
+    public:
+        typedef Code StoredType;
+        typedef double ValueType;
+
+        /**
+         * Creates the storage for a range of levels.
+         *
+         * @param floor lowest stored level in dB
+         * @param ceiling highest stored level in dB
+         * @throw Aquila::ConfigurationException for an empty range
+         */
+        DecibelStorage(double floor, double ceiling):
+            m_floor(floor), m_step((ceiling - floor) / std::numeric_limits<Code>::max())
+        {
+            if (!(ceiling > floor))
+            {
+                throw ConfigurationException("dB ceiling must be above the floor!");
+            }
+        }
+
+        StoredType store(ComplexType bin) const
+        {
+            const double max = std::numeric_limits<Code>::max();
+            const double code = (dB(bin) - m_floor) / m_step;
+            return static_cast<Code>(clamp(0.0, code, max) + 0.5);
+        }
+
+        ValueType load(StoredType stored) const
+        {
+            return m_floor + stored * m_step;
+        }
+
+        /**
+         * Returns the level difference of consecutive codes.
+         *
+         * @return step in dB
+         */
+        double getStep() const
+        {
+            return m_step;
+        }
+
+    private:
+        /**
+         * Level of code 0, in dB.
+         */
+        double m_floor;
+
+        /**
+         * Level difference of consecutive codes, in dB.
+         */
+        double m_step;
+    };
+
+    /**
+     * 8-bit dB storage.
+     */
+    typedef DecibelStorage<std::uint8_t> Decibel8Storage;
+
+    /**
+     * 16-bit dB storage.
+     */
+    typedef DecibelStorage<std::uint16_t> Decibel16Storage;
+
+    /**
+     * Spectrogram of the most recent frames of a stream.
+     *
+     * Frames are pushed one by one or in groups; each is transformed at
+     * once and its N/2+1 non-redundant bins are written to a ring buffer
+     * of a fixed number of frames, overwriting the oldest frame when the
+     * ring is full. Memory use is therefore constant: capacity * (N/2+1)
+     * stored bins, plus the FFT scratch.
+     *
+     * The Storage policy decides what is kept of each bin: ComplexStorage
+     * (the complex value), MagnitudeStorage (a float magnitude, 4 bytes)
+     * or Decibel8Storage / Decibel16Storage (a quantized level, 1 or 2
+     * bytes, compared to 16 bytes of a complex bin).
+     *
+     * Retained frames are accessed by their position, 0 being the oldest
+     * one still kept; getFirstFrame() tells its number in the whole stream.
+     */
+    template <typename Storage = ComplexStorage>
+    class StreamingSpectrogram
+    {
+    public:
+        typedef typename Storage::StoredType StoredType;
+        typedef typename Storage::ValueType ValueType;
+
+        /**
+         * Creates an empty spectrogram.
+         *
+         * @param spectrumSize frame length (FFT size)
+         * @param capacity maximum number of retained frames
+         * @param storage storage policy
+         * @throw Aquila::ConfigurationException for a zero capacity
+         */
+        StreamingSpectrogram(std::size_t spectrumSize, std::size_t capacity,
+                             const Storage& storage = Storage()):
+            m_spectrumSize(spectrumSize), m_binCount(spectrumSize / 2 + 1),
+            m_capacity(capacity), m_frameCount(0), m_totalFrameCount(0),
+            m_next(0), m_storage(storage),
+            m_fft(FftFactory::getFft(spectrumSize)),
+            m_data(capacity * m_binCount), m_spectra(BATCH * m_binCount)
+        {
+            if (0 == m_capacity)
+            {
+                throw ConfigurationException("Capacity must not be zero!");
+            }
+        }
+
+        /**
+         * Returns spectrum size (frame length).
+         *
+         * @return spectrum size
+         */
+        std::size_t getSpectrumSize() const
+        {
+            return m_spectrumSize;
+        }
+
+        /**
+         * Returns number of stored bins of each frame (N/2+1).
+         *
+         * @return bin count
+         */
+        std::size_t getBinCount() const
+        {
+            return m_binCount;
+        }
+
+        /**
+         * Returns maximum number of retained frames.
+         *
+         * @return capacity
+         */
+        std::size_t getCapacity() const
+        {
+            return m_capacity;
+        }
+
+        /**
+         * Returns number of retained frames.
+         *
+         * @return frame count
+         */
+        std::size_t getFrameCount() const
+        {
+            return m_frameCount;
+        }
+
+        /**
+         * Returns number of frames pushed since creation or clear().
+         *
+         * @return total frame count
+         */
+        std::size_t getTotalFrameCount() const
+        {
+            return m_totalFrameCount;
+        }
+
+        /**
+         * Returns stream position of the oldest retained frame.
+         *
+         * @return frame number in the whole stream
+         */
+        std::size_t getFirstFrame() const
+        {
+            return m_totalFrameCount - m_frameCount;
+        }
+
+        /**
+         * Returns the stored bins of a retained frame.
+         *
+         * @param frame frame position, 0 for the oldest retained frame
+         * @return pointer to N/2+1 stored bins
+         */
+        const StoredType* getSpectrum(std::size_t frame) const
+        {
+            std::size_t slot = m_next + m_capacity - m_frameCount + frame;
+            if (slot >= m_capacity)
+            {
+                slot -= m_capacity;
+            }
+            return &m_data[slot * m_binCount];
+        }
+
+        /**
+         * Returns a bin value of a retained frame.
+         *
+         * @param frame frame position, 0 for the oldest retained frame
+         * @param bin bin number, up to N/2
+         * @return value read back through the storage policy
+         */
+        ValueType getPoint(std::size_t frame, std::size_t bin) const
+        {
+            return m_storage.load(getSpectrum(frame)[bin]);
+        }
+
+        /**
+         * Transforms and stores a frame.
+         *
+         * @param x frame samples (N values)
+         */
+        void push(const SampleType x[])
+        {
+            push(&x, 1);
+        }
+
+        /**
+         * Transforms and stores several frames, in order.
+         *
+         * @param x pointers to count frames (N samples each)
+         * @param count number of frames
+         */
+        void push(const SampleType* const x[], std::size_t count)
+        {
+            for (std::size_t first = 0; first < count; first += BATCH)
+            {
+                const std::size_t frames = std::min(BATCH, count - first);
+                m_fft->rfftBatch(x + first, frames, &m_spectra[0]);
+                for (std::size_t i = 0; i < frames; ++i)
+                {
+                    store(&m_spectra[i * m_binCount]);
+                }
+            }
+        }
+
+        /**
+         * Transforms and stores all frames of a collection, in order.
+         *
+         * @param frames frames of spectrum size length
+         * @throw Aquila::ConfigurationException for a wrong frame length
+         */
+        void push(const FramesCollection& frames)
+        {
+            push(frames.views());
+        }
+
+        /**
+         * Transforms and stores a range of frame views, in order.
+         *
+         * @param frames frames of spectrum size length
+         * @throw Aquila::ConfigurationException for a wrong frame length
+         */
+        void push(const FrameViewRange& frames)
+        {
+            if (frames.count() > 0 && frames.getSamplesPerFrame() != m_spectrumSize)
+            {
+                throw ConfigurationException("Frame length must match spectrum size!");
+            }
+            const SampleType* inputs[BATCH];
+            std::size_t count = 0;
+            for (auto it = frames.begin(); it != frames.end(); ++it)
+            {
+                inputs[count++] = (*it).toArray();
+                if (BATCH == count)
+                {
+                    push(inputs, count);
+                    count = 0;
+                }
+            }
+            push(inputs, count);
+        }
+
+        /**
+         * Forgets all frames.
+         */
+        void clear()
+        {
+            m_frameCount = 0;
+            m_totalFrameCount = 0;
+            m_next = 0;
+        }
+
+    private:
+        /**
+         * Frames transformed by one rfftBatch() call.
+         */
+        static const std::size_t BATCH = 8;
+
+        /**
+         * Writes a spectrum into the next ring slot.
+         *
+         * @param spectrum N/2+1 complex bins
+         */
+        void store(const ComplexType spectrum[])
+        {
+            StoredType* out = &m_data[m_next * m_binCount];
+            for (std::size_t k = 0; k < m_binCount; ++k)
+            {
+                out[k] = m_storage.store(spectrum[k]);
+            }
+            if (++m_next == m_capacity)
+            {
+                m_next = 0;
+            }
+            if (m_frameCount < m_capacity)
+            {
+                ++m_frameCount;
+            }
+            ++m_totalFrameCount;
+        }
+
+        /**
+         * Spectrum size.
+         */
+        std::size_t m_spectrumSize;
+
+        /**
+         * Stored bins per frame.
+         */
+        std::size_t m_binCount;
+
+        /**
+         * Ring capacity in frames.
+         */
+        std::size_t m_capacity;
+
+        /**
+         * Number of retained frames.
+         */
+        std::size_t m_frameCount;
+
+        /**
+         * Number of frames pushed so far.
+         */
+        std::size_t m_totalFrameCount;
+
+        /**
+         * Ring slot of the next frame.
+         */
+        std::size_t m_next;
+
+        /**
+         * Storage policy.
+         */
+        Storage m_storage;
+
+        /**
+         * FFT object of spectrum size.
+         */
+        std::shared_ptr<Fft> m_fft;
+
+        /**
+         * Ring of stored bins, capacity * (N/2+1).
+         */
+        std::vector<StoredType> m_data;
+
+        /**
+         * Complex spectra of one batch of frames.
+         */
+        SpectrumType m_spectra;
+    };
+
+    template <typename Storage>
+    const std::size_t StreamingSpectrogram<Storage>::BATCH;
+}
+
+#endif // STREAMINGSPECTROGRAM_H
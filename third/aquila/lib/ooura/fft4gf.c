@@ -0,0 +1,41 @@
+/*
+Single precision build of fft4g.c.
+
+Every double in the original source becomes a float and all external
+functions get an "f" suffix, so both versions can be linked together:
+
+    cdftf: Complex Discrete Fourier Transform
+    rdftf: Real Discrete Fourier Transform
+    ddctf: Discrete Cosine Transform
+    ddstf: Discrete Sine Transform
+    dfctf: Cosine Transform of RDFT (Real Symmetric DFT)
+    dfstf: Sine Transform of RDFT (Real Anti-symmetric DFT)
+
+The function arguments are the same as in fft4g.c, with float arrays.
+*/
+
+/* the math declarations must keep their double signatures */
+#include <math.h>
+
+#define double float
+
+#define cdft cdftf
+#define rdft rdftf
+#define ddct ddctf
+#define ddst ddstf
+#define dfct dfctf
+#define dfst dfstf
+#define makewt makewtf
+#define makect makectf
+#define bitrv2 bitrv2f
+#define bitrv2conj bitrv2conjf
+#define cftfsub cftfsubf
+#define cftbsub cftbsubf
+#define cft1st cft1stf
+#define cftmdl cftmdlf
+#define rftfsub rftfsubf
+#define rftbsub rftbsubf
+#define dctsub dctsubf
+#define dstsub dstsubf
+
+#include "fft4g.c"
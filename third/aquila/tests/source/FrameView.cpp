@@ -0,0 +1,87 @@
+#include "aquila/global.h"
+#include "aquila/Exceptions.h"
+#include "aquila/source/SignalSource.h"
+#include "aquila/source/FramesCollection.h"
+#include "aquila/source/FrameView.h"
+#include "UnitTest++/UnitTest++.h"
+#include <algorithm>
+#include <cstddef>
+
+SUITE(FrameView)
+{
+    const int SIZE = 10;
+    Aquila::SampleType testArray[SIZE] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    Aquila::FrequencyType sampleFrequency = 100;
+    Aquila::SignalSource data(testArray, SIZE, sampleFrequency);
+
+    TEST(View)
+    {
+        Aquila::FrameView view(testArray + 3, 4);
+        CHECK_EQUAL(4u, view.length());
+        CHECK_EQUAL(testArray + 3, view.toArray());
+        CHECK_EQUAL(5, view[2]);
+        CHECK(std::equal(view.begin(), view.end(), testArray + 3));
+    }
+
+    TEST(ApplyWindow)
+    {
+        Aquila::FrameView view(testArray + 2, 3);
+        Aquila::SampleType window[3] = {0.5, 1.0, 2.0};
+        Aquila::SampleType out[3];
+        view.applyWindow(window, out);
+        Aquila::SampleType expected[3] = {1.0, 3.0, 8.0};
+        CHECK_ARRAY_CLOSE(expected, out, 3, 0.000001);
+        // the frame itself is not modified
+        CHECK_EQUAL(2, testArray[2]);
+    }
+
+    TEST(CollectionViews)
+    {
+        const unsigned int layouts[][2] = {{5, 0}, {2, 0}, {1, 0}, {10, 0}, {7, 0}, {5, 4}, {4, 2}, {3, 1}};
+        for (std::size_t l = 0; l < 8; ++l)
+        {
+            Aquila::FramesCollection frames(data, layouts[l][0], layouts[l][1]);
+            Aquila::FrameViewRange views = frames.views();
+            CHECK_EQUAL(frames.count(), views.count());
+            CHECK_EQUAL(frames.getSamplesPerFrame(), views.getSamplesPerFrame());
+            std::size_t i = 0;
+            for (auto it = views.begin(); it != views.end(); ++it, ++i)
+            {
+                CHECK_EQUAL(frames.frame(i).toArray(), (*it).toArray());
+                CHECK_EQUAL(frames.frame(i).length(), (*it).length());
+                CHECK_EQUAL(frames.frame(i).toArray(), views[i].toArray());
+            }
+            CHECK_EQUAL(frames.count(), i);
+        }
+    }
+
+    TEST(LazyViews)
+    {
+        const unsigned int layouts[][2] = {{5, 0}, {2, 0}, {1, 0}, {10, 0}, {7, 0}, {11, 0}, {5, 4}, {4, 2}, {3, 1}};
+        for (std::size_t l = 0; l < 9; ++l)
+        {
+            Aquila::FramesCollection frames(data, layouts[l][0], layouts[l][1]);
+            Aquila::FrameViewRange views = Aquila::FramesCollection::divideViews(
+                data, layouts[l][0], layouts[l][1]);
+            CHECK_EQUAL(frames.count(), views.count());
+            for (std::size_t i = 0; i < views.count(); ++i)
+            {
+                CHECK_EQUAL(frames.frame(i).toArray(), views[i].toArray());
+            }
+        }
+    }
+
+    TEST(EmptyViews)
+    {
+        Aquila::FramesCollection frames;
+        CHECK_EQUAL(0u, frames.views().count());
+        CHECK(frames.views().begin() == frames.views().end());
+        CHECK_EQUAL(0u, Aquila::FramesCollection::divideViews(data, 0).count());
+    }
+
+    TEST(FullOverlap)
+    {
+        CHECK_THROW(Aquila::FramesCollection::divideViews(data, 4, 4),
+                    Aquila::ConfigurationException);
+    }
+}
@@ -0,0 +1,47 @@
+#include "aquila/global.h"
+#include "aquila/source/window/GaussianWindow.h"
+#include "aquila/source/window/HammingWindow.h"
+#include "aquila/source/window/HannWindow.h"
+#include "aquila/source/window/WindowCache.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cstddef>
+
+SUITE(WindowCache)
+{
+    TEST(SameCoefficients)
+    {
+        const std::size_t SIZE = 64;
+        Aquila::HammingWindow hamming(SIZE);
+        auto table = Aquila::WindowCache::get(Aquila::WindowCache::Hamming, SIZE);
+        CHECK_EQUAL(SIZE, table->size());
+        CHECK_ARRAY_EQUAL(hamming.toArray(), &(*table)[0], SIZE);
+
+        Aquila::GaussianWindow gaussian(SIZE, 0.3);
+        auto gaussianTable = Aquila::WindowCache::get(Aquila::WindowCache::Gaussian, SIZE, 0.3);
+        CHECK_ARRAY_EQUAL(gaussian.toArray(), &(*gaussianTable)[0], SIZE);
+    }
+
+    TEST(Shared)
+    {
+        auto first = Aquila::WindowCache::get(Aquila::WindowCache::Hann, 128);
+        auto second = Aquila::WindowCache::get(Aquila::WindowCache::Hann, 128);
+        CHECK(first == second);
+        // the parameter only matters to the Gaussian window
+        auto third = Aquila::WindowCache::get(Aquila::WindowCache::Hann, 128, 0.1);
+        CHECK(first == third);
+    }
+
+    TEST(DistinctKeys)
+    {
+        auto hann = Aquila::WindowCache::get(Aquila::WindowCache::Hann, 128);
+        CHECK(hann != Aquila::WindowCache::get(Aquila::WindowCache::Hann, 256));
+        CHECK(hann != Aquila::WindowCache::get(Aquila::WindowCache::Hamming, 128));
+        auto gaussian = Aquila::WindowCache::get(Aquila::WindowCache::Gaussian, 128, 0.5);
+        CHECK(gaussian != Aquila::WindowCache::get(Aquila::WindowCache::Gaussian, 128, 0.4));
+    }
+
+    TEST(Empty)
+    {
+        CHECK_EQUAL(0u, Aquila::WindowCache::get(Aquila::WindowCache::Hamming, 0)->size());
+    }
+}
@@ -1,7 +1,55 @@
 #include "Fft.h"
 #include "aquila/global.h"
 #include "aquila/transform/AquilaFft.h"
+#include "aquila/transform/OouraFft.h"
 #include "UnitTest++/UnitTest++.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Test that all transforms agree with OouraFft, including the inverse of
+ * a spectrum which is not conjugate-symmetric.
+ */
+void matchesOouraTest(std::size_t size)
+{
+#ifdef AQUILA_SINGLE_PRECISION
+    const double tolerance = size * 0.00001;
+#else
+    const double tolerance = size * 0.0000001;
+#endif
+    std::vector<Aquila::SampleType> testArray(size);
+    Aquila::SpectrumType data(size), reference(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        testArray[i] = std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i) + 0.1 * (i % 7);
+        data[i] = reference[i] = Aquila::ComplexType(testArray[i], std::cos(0.11 * i));
+    }
+
+    Aquila::AquilaFft fft(size);
+    Aquila::OouraFft ooura(size);
+
+    Aquila::SpectrumType expected = ooura.rfft(&testArray[0]);
+    Aquila::SpectrumType actual = fft.rfft(&testArray[0]);
+    for (std::size_t k = 0; k <= size / 2; ++k)
+    {
+        CHECK_CLOSE(expected[k].real(), actual[k].real(), tolerance);
+        CHECK_CLOSE(expected[k].imag(), actual[k].imag(), tolerance);
+    }
+
+    std::vector<Aquila::SampleType> expectedSignal(size), actualSignal(size);
+    ooura.ifft(&data[0], &expectedSignal[0]);
+    fft.ifft(&data[0], &actualSignal[0]);
+    CHECK_ARRAY_CLOSE(expectedSignal, actualSignal, size, tolerance);
+
+    ooura.fftInPlace(&reference[0]);
+    fft.fftInPlace(&data[0]);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        CHECK_CLOSE(reference[k].real(), data[k].real(), tolerance);
+        CHECK_CLOSE(reference[k].imag(), data[k].imag(), tolerance);
+    }
+}
 
 
 SUITE(AquilaFft)
@@ -22,6 +70,22 @@ SUITE(AquilaFft)
         constSpectrumTest<Aquila::AquilaFft, 1024>();
     }
 
+    TEST(DeltaInverse)
+    {
+        deltaInverseTest<Aquila::AquilaFft, 8>();
+        deltaInverseTest<Aquila::AquilaFft, 16>();
+        deltaInverseTest<Aquila::AquilaFft, 128>();
+        deltaInverseTest<Aquila::AquilaFft, 1024>();
+    }
+
+    TEST(ConstInverse)
+    {
+        constInverseTest<Aquila::AquilaFft, 8>();
+        constInverseTest<Aquila::AquilaFft, 16>();
+        constInverseTest<Aquila::AquilaFft, 128>();
+        constInverseTest<Aquila::AquilaFft, 1024>();
+    }
+
     TEST(Identity)
     {
         identityTest<Aquila::AquilaFft, 8>();
@@ -29,4 +93,42 @@ SUITE(AquilaFft)
         identityTest<Aquila::AquilaFft, 128>();
         identityTest<Aquila::AquilaFft, 1024>();
     }
+
+    TEST(RealSpectrum)
+    {
+        realSpectrumTest<Aquila::AquilaFft, 8>();
+        realSpectrumTest<Aquila::AquilaFft, 16>();
+        realSpectrumTest<Aquila::AquilaFft, 128>();
+        realSpectrumTest<Aquila::AquilaFft, 1024>();
+    }
+
+    TEST(RealIdentity)
+    {
+        realIdentityTest<Aquila::AquilaFft, 8>();
+        realIdentityTest<Aquila::AquilaFft, 16>();
+        realIdentityTest<Aquila::AquilaFft, 128>();
+        realIdentityTest<Aquila::AquilaFft, 1024>();
+    }
+
+    TEST(InPlace)
+    {
+        inPlaceTest<Aquila::AquilaFft, 8>();
+        inPlaceTest<Aquila::AquilaFft, 16>();
+        inPlaceTest<Aquila::AquilaFft, 128>();
+        inPlaceTest<Aquila::AquilaFft, 1024>();
+    }
+
+    TEST(MatchesOoura)
+    {
+        for (std::size_t size = 2; size <= 4096; size *= 2)
+        {
+            matchesOouraTest(size);
+        }
+    }
+
+    TEST(Windowed)
+    {
+        Aquila::AquilaFft fft(512);
+        rfftWindowedTest(fft, 512);
+    }
 }
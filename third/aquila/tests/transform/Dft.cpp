@@ -45,4 +45,34 @@ SUITE(Dft)
         identityTest<Aquila::Dft, 128>();
         identityTest<Aquila::Dft, 1024>();
     }
+
+    TEST(RealSpectrum)
+    {
+        realSpectrumTest<Aquila::Dft, 8>();
+        realSpectrumTest<Aquila::Dft, 16>();
+        realSpectrumTest<Aquila::Dft, 128>();
+        realSpectrumTest<Aquila::Dft, 1024>();
+    }
+
+    TEST(RealIdentity)
+    {
+        realIdentityTest<Aquila::Dft, 8>();
+        realIdentityTest<Aquila::Dft, 16>();
+        realIdentityTest<Aquila::Dft, 128>();
+        realIdentityTest<Aquila::Dft, 1024>();
+    }
+
+    TEST(InPlace)
+    {
+        inPlaceTest<Aquila::Dft, 8>();
+        inPlaceTest<Aquila::Dft, 16>();
+        inPlaceTest<Aquila::Dft, 128>();
+        inPlaceTest<Aquila::Dft, 1024>();
+    }
+
+    TEST(Windowed)
+    {
+        Aquila::Dft fft(64);
+        rfftWindowedTest(fft, 64);
+    }
 }
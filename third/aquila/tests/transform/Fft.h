@@ -9,7 +9,9 @@
 #include "aquila/transform/AquilaFft.h"
 #include "UnitTest++/UnitTest++.h"
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <vector>
 
 /**
  * Test that spectrum of a delta signal is constant.
@@ -108,4 +110,157 @@ void identityTest()
     CHECK_ARRAY_CLOSE(testArray, output, SIZE, 0.0001);
 }
 
+/**
+ * Test that the real-input transform matches the lower half of fft().
+ */
+template <typename FftType, std::size_t SIZE>
+void realSpectrumTest()
+{
+    Aquila::SampleType testArray[SIZE];
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        testArray[i] = 1.0 + std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i);
+    }
+
+    FftType fft(SIZE);
+    Aquila::SpectrumType spectrum = fft.fft(testArray);
+    Aquila::SpectrumType halfSpectrum = fft.rfft(testArray);
+    CHECK_EQUAL(SIZE / 2 + 1, halfSpectrum.size());
+
+    double expectedRe[SIZE / 2 + 1], expectedIm[SIZE / 2 + 1];
+    double actualRe[SIZE / 2 + 1], actualIm[SIZE / 2 + 1];
+    for (std::size_t k = 0; k <= SIZE / 2; ++k)
+    {
+        expectedRe[k] = spectrum[k].real();
+        expectedIm[k] = spectrum[k].imag();
+        actualRe[k] = halfSpectrum[k].real();
+        actualIm[k] = halfSpectrum[k].imag();
+    }
+    CHECK_ARRAY_CLOSE(expectedRe, actualRe, SIZE / 2 + 1, 0.0001);
+    CHECK_ARRAY_CLOSE(expectedIm, actualIm, SIZE / 2 + 1, 0.0001);
+}
+
+/**
+ * Test that IRFFT(RFFT(x)) == x.
+ */
+template <typename FftType, std::size_t SIZE>
+void realIdentityTest()
+{
+    Aquila::SampleType testArray[SIZE];
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        testArray[i] = 2.0 + std::sin(0.3 * i);
+    }
+
+    FftType fft(SIZE);
+    Aquila::SpectrumType spectrum = fft.rfft(testArray);
+
+    Aquila::SampleType output[SIZE];
+    fft.irfft(spectrum, output);
+
+    CHECK_ARRAY_CLOSE(testArray, output, SIZE, 0.0001);
+}
+
+/**
+ * Test that the in-place transform matches fft() and that the in-place
+ * inverse restores the input.
+ */
+template <typename FftType, std::size_t SIZE>
+void inPlaceTest()
+{
+    Aquila::SampleType testArray[SIZE];
+    Aquila::ComplexType data[SIZE];
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        testArray[i] = std::sin(0.3 * i) - 0.5 * std::cos(1.7 * i);
+        data[i] = testArray[i];
+    }
+
+    FftType fft(SIZE);
+    Aquila::ComplexType spectrum[SIZE];
+    fft.fft(testArray, spectrum);
+    fft.fftInPlace(data);
+
+    double expected[SIZE], actual[SIZE];
+    for (std::size_t k = 0; k < SIZE; ++k)
+    {
+        expected[k] = std::abs(spectrum[k]);
+        actual[k] = std::abs(data[k]);
+    }
+    CHECK_ARRAY_CLOSE(expected, actual, SIZE, 0.0001);
+
+    fft.ifftInPlace(data);
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        actual[i] = data[i].real();
+    }
+    CHECK_ARRAY_CLOSE(testArray, actual, SIZE, 0.0001);
+}
+
+/**
+ * Test that a batch of real transforms matches separate rfft() calls.
+ */
+template <typename FftType>
+void rfftBatchTest(FftType& fft, std::size_t size, std::size_t count)
+{
+#ifdef AQUILA_SINGLE_PRECISION
+    const double tolerance = size * 0.00001;
+#else
+    const double tolerance = size * 0.0000001;
+#endif
+    std::vector<Aquila::SampleType> signals(size * count);
+    std::vector<const Aquila::SampleType*> inputs(count);
+    for (std::size_t b = 0; b < count; ++b)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            signals[b * size + i] = std::sin(0.3 * i + b) + 0.1 * ((i + b) % 5);
+        }
+        inputs[b] = &signals[b * size];
+    }
+
+    const std::size_t bins = size / 2 + 1;
+    Aquila::SpectrumType spectra(bins * count);
+    fft.rfftBatch(&inputs[0], count, &spectra[0]);
+    for (std::size_t b = 0; b < count; ++b)
+    {
+        Aquila::SpectrumType expected = fft.rfft(inputs[b]);
+        for (std::size_t k = 0; k < bins; ++k)
+        {
+            CHECK_CLOSE(expected[k].real(), spectra[b * bins + k].real(), tolerance);
+            CHECK_CLOSE(expected[k].imag(), spectra[b * bins + k].imag(), tolerance);
+        }
+    }
+}
+
+/**
+ * Test that the windowed real transform matches windowing followed
+ * by rfft().
+ */
+template <typename FftType>
+void rfftWindowedTest(FftType& fft, std::size_t size)
+{
+#ifdef AQUILA_SINGLE_PRECISION
+    const double tolerance = size * 0.00001;
+#else
+    const double tolerance = size * 0.0000001;
+#endif
+    std::vector<Aquila::SampleType> signal(size), window(size), windowed(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        signal[i] = std::sin(0.3 * i) + 0.2 * std::cos(2.1 * i);
+        window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / (size - 1.0));
+        windowed[i] = signal[i] * window[i];
+    }
+
+    Aquila::SpectrumType expected = fft.rfft(&windowed[0]);
+    Aquila::SpectrumType actual(size / 2 + 1);
+    fft.rfftWindowed(&signal[0], &window[0], &actual[0]);
+    for (std::size_t k = 0; k <= size / 2; ++k)
+    {
+        CHECK_CLOSE(expected[k].real(), actual[k].real(), tolerance);
+        CHECK_CLOSE(expected[k].imag(), actual[k].imag(), tolerance);
+    }
+}
+
 #endif // AQUILA_TEST_FFT_H
@@ -0,0 +1,50 @@
+#include "aquila/global.h"
+#include "aquila/transform/AquilaFft.h"
+#include "aquila/transform/FftFactory.h"
+#include "aquila/transform/FixedFft.h"
+#include "aquila/transform/OouraFft.h"
+#include "aquila/transform/SimdFft.h"
+#include "UnitTest++/UnitTest++.h"
+#include <memory>
+
+
+SUITE(FftFactory)
+{
+    TEST(ExplicitBackend)
+    {
+        using Aquila::FftFactory;
+        CHECK(std::dynamic_pointer_cast<Aquila::OouraFft>(FftFactory::getFft(1024, FftFactory::Ooura)));
+        CHECK(std::dynamic_pointer_cast<Aquila::FixedFft<1024>>(FftFactory::getFft(1024, FftFactory::Fixed)));
+        CHECK(std::dynamic_pointer_cast<Aquila::SimdFft>(FftFactory::getFft(1024, FftFactory::Simd)));
+        CHECK(std::dynamic_pointer_cast<Aquila::AquilaFft>(FftFactory::getFft(1024, FftFactory::Portable)));
+    }
+
+    TEST(UnsupportedLengthFallsBack)
+    {
+        using Aquila::FftFactory;
+        CHECK(std::dynamic_pointer_cast<Aquila::OouraFft>(FftFactory::getFft(128, FftFactory::Fixed)));
+        CHECK(std::dynamic_pointer_cast<Aquila::OouraFft>(FftFactory::getFft(1000, FftFactory::Simd)));
+    }
+
+    TEST(ProcessBackend)
+    {
+        using Aquila::FftFactory;
+        CHECK_EQUAL(FftFactory::Automatic, FftFactory::getBackend());
+        FftFactory::setBackend(FftFactory::Simd);
+        CHECK(std::dynamic_pointer_cast<Aquila::SimdFft>(FftFactory::getFft(512)));
+        FftFactory::setBackend(FftFactory::Automatic);
+        CHECK(std::dynamic_pointer_cast<Aquila::FixedFft<512>>(FftFactory::getFft(512)));
+    }
+
+    TEST(Tune)
+    {
+        using Aquila::FftFactory;
+        FftFactory::BackendType tuned = FftFactory::tune(256);
+        CHECK(tuned == FftFactory::Ooura || tuned == FftFactory::Fixed ||
+              tuned == FftFactory::Simd || tuned == FftFactory::Portable);
+        // remembered for the rest of the process
+        CHECK_EQUAL(tuned, FftFactory::tune(256));
+        CHECK(FftFactory::getFft(256, FftFactory::Tuned));
+        CHECK_EQUAL(FftFactory::Ooura, FftFactory::tune(1000));
+    }
+}
@@ -0,0 +1,154 @@
+#include "Fft.h"
+#include "aquila/global.h"
+#include "aquila/Exceptions.h"
+#include "aquila/transform/FixedFft.h"
+#include "aquila/transform/FftFactory.h"
+#include "aquila/transform/OouraFft.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Test that both the real and the complex transforms agree with OouraFft.
+ */
+template <std::size_t SIZE>
+void matchesOouraTest()
+{
+#ifdef AQUILA_SINGLE_PRECISION
+    const double tolerance = SIZE * 0.00001;
+#else
+    const double tolerance = SIZE * 0.0000001;
+#endif
+    std::vector<Aquila::SampleType> testArray(SIZE);
+    Aquila::SpectrumType data(SIZE), reference(SIZE);
+    for (std::size_t i = 0; i < SIZE; ++i)
+    {
+        testArray[i] = std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i) + 0.1 * (i % 7);
+        data[i] = reference[i] = Aquila::ComplexType(testArray[i], std::cos(0.11 * i));
+    }
+
+    Aquila::FixedFft<SIZE> fft;
+    Aquila::OouraFft ooura(SIZE);
+
+    Aquila::SpectrumType expected = ooura.rfft(&testArray[0]);
+    Aquila::SpectrumType actual = fft.rfft(&testArray[0]);
+    for (std::size_t k = 0; k <= SIZE / 2; ++k)
+    {
+        CHECK_CLOSE(expected[k].real(), actual[k].real(), tolerance);
+        CHECK_CLOSE(expected[k].imag(), actual[k].imag(), tolerance);
+    }
+
+    ooura.fftInPlace(&reference[0]);
+    fft.fftInPlace(&data[0]);
+    for (std::size_t k = 0; k < SIZE; ++k)
+    {
+        CHECK_CLOSE(reference[k].real(), data[k].real(), tolerance);
+        CHECK_CLOSE(reference[k].imag(), data[k].imag(), tolerance);
+    }
+}
+
+
+SUITE(FixedFft)
+{
+    TEST(Delta)
+    {
+        deltaSpectrumTest<Aquila::FixedFft<256>, 256>();
+        deltaSpectrumTest<Aquila::FixedFft<512>, 512>();
+        deltaSpectrumTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(ConstSignal)
+    {
+        constSpectrumTest<Aquila::FixedFft<256>, 256>();
+        constSpectrumTest<Aquila::FixedFft<512>, 512>();
+        constSpectrumTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(DeltaInverse)
+    {
+        deltaInverseTest<Aquila::FixedFft<256>, 256>();
+        deltaInverseTest<Aquila::FixedFft<512>, 512>();
+        deltaInverseTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(ConstInverse)
+    {
+        constInverseTest<Aquila::FixedFft<256>, 256>();
+        constInverseTest<Aquila::FixedFft<512>, 512>();
+        constInverseTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(Identity)
+    {
+        identityTest<Aquila::FixedFft<256>, 256>();
+        identityTest<Aquila::FixedFft<512>, 512>();
+        identityTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(RealSpectrum)
+    {
+        realSpectrumTest<Aquila::FixedFft<256>, 256>();
+        realSpectrumTest<Aquila::FixedFft<512>, 512>();
+        realSpectrumTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(RealIdentity)
+    {
+        realIdentityTest<Aquila::FixedFft<256>, 256>();
+        realIdentityTest<Aquila::FixedFft<512>, 512>();
+        realIdentityTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(InPlace)
+    {
+        inPlaceTest<Aquila::FixedFft<256>, 256>();
+        inPlaceTest<Aquila::FixedFft<512>, 512>();
+        inPlaceTest<Aquila::FixedFft<1024>, 1024>();
+    }
+
+    TEST(FreshInverse)
+    {
+        // the first call on a new object must find the tables of the
+        // full-length complex transform ready
+        Aquila::FixedFft<4096> fft;
+        std::vector<Aquila::SampleType> signal(4096), output(4096);
+        for (std::size_t i = 0; i < 4096; ++i)
+        {
+            signal[i] = std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i);
+        }
+        Aquila::OouraFft ooura(4096);
+        Aquila::SpectrumType spectrum = ooura.fft(&signal[0]);
+        fft.ifft(&spectrum[0], &output[0]);
+        CHECK_ARRAY_CLOSE(signal, output, 4096, 0.0001);
+    }
+
+    TEST(MatchesOoura)
+    {
+        matchesOouraTest<256>();
+        matchesOouraTest<512>();
+        matchesOouraTest<1024>();
+        matchesOouraTest<2048>();
+        matchesOouraTest<4096>();
+    }
+
+    TEST(WrongLength)
+    {
+        CHECK_THROW(Aquila::FixedFft<256> fft(512), Aquila::ConfigurationException);
+    }
+
+    TEST(FactoryDispatch)
+    {
+        CHECK(std::dynamic_pointer_cast<Aquila::FixedFft<1024>>(Aquila::FftFactory::getFft(1024)));
+        CHECK(std::dynamic_pointer_cast<Aquila::OouraFft>(Aquila::FftFactory::getFft(128)));
+    }
+
+    TEST(Windowed)
+    {
+        Aquila::FixedFft<256> fft256;
+        rfftWindowedTest(fft256, 256);
+        Aquila::FixedFft<2048> fft2048;
+        rfftWindowedTest(fft2048, 2048);
+    }
+}
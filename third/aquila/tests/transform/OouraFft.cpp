@@ -45,4 +45,40 @@ SUITE(OouraFft)
         identityTest<Aquila::OouraFft, 128>();
         identityTest<Aquila::OouraFft, 1024>();
     }
+
+    TEST(RealSpectrum)
+    {
+        realSpectrumTest<Aquila::OouraFft, 8>();
+        realSpectrumTest<Aquila::OouraFft, 16>();
+        realSpectrumTest<Aquila::OouraFft, 128>();
+        realSpectrumTest<Aquila::OouraFft, 1024>();
+    }
+
+    TEST(RealIdentity)
+    {
+        realIdentityTest<Aquila::OouraFft, 8>();
+        realIdentityTest<Aquila::OouraFft, 16>();
+        realIdentityTest<Aquila::OouraFft, 128>();
+        realIdentityTest<Aquila::OouraFft, 1024>();
+    }
+
+    TEST(InPlace)
+    {
+        inPlaceTest<Aquila::OouraFft, 8>();
+        inPlaceTest<Aquila::OouraFft, 16>();
+        inPlaceTest<Aquila::OouraFft, 128>();
+        inPlaceTest<Aquila::OouraFft, 1024>();
+    }
+
+    TEST(Batch)
+    {
+        Aquila::OouraFft fft(256);
+        rfftBatchTest(fft, 256, 5);
+    }
+
+    TEST(Windowed)
+    {
+        Aquila::OouraFft fft(512);
+        rfftWindowedTest(fft, 512);
+    }
 }
@@ -0,0 +1,115 @@
+#include "aquila/global.h"
+#include "aquila/Exceptions.h"
+#include "aquila/source/generator/SineGenerator.h"
+#include "aquila/source/FramesCollection.h"
+#include "aquila/transform/ParallelSpectrogram.h"
+#include "aquila/transform/Spectrogram.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cstddef>
+#include <memory>
+
+
+SUITE(ParallelSpectrogram)
+{
+    Aquila::FrequencyType sampleFrequency = 8000;
+
+    TEST(SameAsSerial)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(440).setAmplitude(1).generate(256 * 300);
+        Aquila::FramesCollection frames(generator, 256, 128);
+        Aquila::Spectrogram serial(frames);
+
+        const std::size_t threadCounts[] = {1, 2, 3, 8};
+        for (std::size_t t = 0; t < 4; ++t)
+        {
+            Aquila::Spectrogram parallel(frames, threadCounts[t]);
+            CHECK_EQUAL(serial.getFrameCount(), parallel.getFrameCount());
+            CHECK_EQUAL(serial.getSpectrumSize(), parallel.getSpectrumSize());
+            for (std::size_t x = 0; x < serial.getFrameCount(); ++x)
+            {
+                for (std::size_t y = 0; y < serial.getSpectrumSize(); ++y)
+                {
+                    CHECK(serial.getPoint(x, y) == parallel.getPoint(x, y));
+                }
+            }
+        }
+    }
+
+    TEST(ChunksInOrder)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(1000).setAmplitude(1).generate(128 * 100);
+        Aquila::FramesCollection frames(generator, 128);
+        Aquila::Spectrogram serial(frames);
+
+        Aquila::ParallelSpectrogram parallel(frames, 3, 16);
+        CHECK_EQUAL(3u, parallel.getThreadCount());
+        CHECK_EQUAL(7u, parallel.getChunkCount());
+        CHECK_EQUAL(4u, parallel.getChunkFrameCount(6));
+
+        const std::size_t bins = 128 / 2 + 1;
+        std::size_t frame = 0;
+        for (std::size_t chunk = 0; chunk < parallel.getChunkCount(); ++chunk)
+        {
+            const Aquila::ComplexType* spectra = parallel.waitForChunk(chunk);
+            for (std::size_t i = 0; i < parallel.getChunkFrameCount(chunk); ++i, ++frame)
+            {
+                for (std::size_t k = 0; k < bins; ++k)
+                {
+                    CHECK(serial.getPoint(frame, k) == spectra[i * bins + k]);
+                }
+            }
+        }
+        CHECK_EQUAL(100u, frame);
+    }
+
+    TEST(DestroyWhileComputing)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(440).setAmplitude(1).generate(1024 * 200);
+        Aquila::FramesCollection frames(generator, 1024);
+        Aquila::Spectrogram serial(frames);
+        const std::size_t bins = 1024 / 2 + 1;
+        {
+            Aquila::ParallelSpectrogram parallel(frames, 2, 1);
+            const Aquila::ComplexType* spectra = parallel.waitForChunk(0);
+            for (std::size_t k = 0; k < bins; ++k)
+            {
+                CHECK(serial.getPoint(0, k) == spectra[k]);
+            }
+        }
+
+        // a cancelled computation leaves nothing behind for the next one
+        Aquila::ParallelSpectrogram parallel(frames, 2, 1);
+        std::shared_ptr<Aquila::SpectrumType> data = parallel.getData();
+        CHECK_EQUAL(200 * bins, data->size());
+        for (std::size_t x = 0; x < serial.getFrameCount(); ++x)
+        {
+            for (std::size_t k = 0; k < bins; ++k)
+            {
+                CHECK(serial.getPoint(x, k) == (*data)[x * bins + k]);
+            }
+        }
+    }
+
+    TEST(NoFrames)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(440).setAmplitude(1).generate(100);
+        Aquila::FramesCollection frames(generator, 128);
+        Aquila::ParallelSpectrogram parallel(frames, 4);
+        parallel.waitForAll();
+        CHECK_EQUAL(0u, parallel.getChunkCount());
+        CHECK_EQUAL(0u, parallel.getThreadCount());
+    }
+
+    TEST(ZeroChunkSize)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(440).setAmplitude(1).generate(1024);
+        Aquila::FramesCollection frames(generator, 128);
+        CHECK_THROW(Aquila::ParallelSpectrogram parallel(frames, 2, 0),
+                    Aquila::ConfigurationException);
+    }
+}
@@ -0,0 +1,133 @@
+#include "aquila/global.h"
+#include "aquila/source/generator/SineGenerator.h"
+#include "aquila/transform/OouraFft.h"
+#include "aquila/transform/PeakPicker.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cmath>
+#include <cstddef>
+
+
+SUITE(PeakPicker)
+{
+    const std::size_t SIZE = 1024;
+    const Aquila::FrequencyType sampleFrequency = 1024;
+
+    Aquila::SpectrumType twoSines(Aquila::FrequencyType f1, double a1,
+                                  Aquila::FrequencyType f2, double a2)
+    {
+        Aquila::SineGenerator first(sampleFrequency), second(sampleFrequency);
+        first.setFrequency(f1).setAmplitude(a1).generate(SIZE);
+        second.setFrequency(f2).setAmplitude(a2).generate(SIZE);
+        first += second;
+
+        Aquila::OouraFft fft(SIZE);
+        return fft.rfft(first.toArray());
+    }
+
+    TEST(SinglePeak)
+    {
+        auto spectrum = twoSines(64, 1, 200, 0.25);
+        Aquila::PeakPicker picker(spectrum.size(), 0, spectrum.size());
+        CHECK_EQUAL(1u, picker.pick(&spectrum[0]));
+        CHECK_EQUAL(64u, picker.getPeak(0).bin);
+        CHECK_CLOSE(std::norm(spectrum[64]), picker.getPeak(0).power, 0.0001);
+    }
+
+    TEST(TotalPower)
+    {
+        auto spectrum = twoSines(64, 1, 200, 0.25);
+        Aquila::PeakPicker picker(spectrum.size(), 10, 301);
+        picker.pick(&spectrum[0]);
+
+        double expected = 0.0;
+        for (std::size_t k = 10; k < 301; ++k)
+        {
+            expected += std::norm(spectrum[k]);
+        }
+#ifdef AQUILA_SINGLE_PRECISION
+        // float sums are only accurate to a few parts per million
+        CHECK_CLOSE(expected, picker.getTotalPower(), expected * 0.00001);
+#else
+        CHECK_CLOSE(expected, picker.getTotalPower(), 0.0001);
+#endif
+        CHECK_CLOSE(std::norm(spectrum[123]), picker.getPowerSpectrum()[123], 0.0001);
+    }
+
+    TEST(Band)
+    {
+        auto spectrum = twoSines(64, 1, 200, 0.25);
+        Aquila::PeakPicker picker(spectrum.size(), 100, 300);
+        CHECK_EQUAL(1u, picker.pick(&spectrum[0]));
+        CHECK_EQUAL(200u, picker.getPeak(0).bin);
+    }
+
+    TEST(TopPeaks)
+    {
+        auto spectrum = twoSines(64, 1, 200, 0.25);
+        Aquila::PeakPicker picker(spectrum.size(), 1, SIZE / 2, 3);
+        CHECK(picker.pick(&spectrum[0]) >= 2u);
+        CHECK_EQUAL(64u, picker.getPeak(0).bin);
+        CHECK_EQUAL(200u, picker.getPeak(1).bin);
+        CHECK(picker.getPeak(0).power > picker.getPeak(1).power);
+    }
+
+    TEST(FirstOfEqualMaxima)
+    {
+        Aquila::SpectrumType spectrum(17, 0.0);
+        spectrum[5] = Aquila::ComplexType(3.0, 4.0);
+        spectrum[11] = Aquila::ComplexType(-4.0, 3.0);
+        Aquila::PeakPicker picker(spectrum.size(), 0, spectrum.size());
+        CHECK_EQUAL(1u, picker.pick(&spectrum[0]));
+        CHECK_EQUAL(5u, picker.getPeak(0).bin);
+        CHECK_CLOSE(25.0, picker.getPeak(0).power, 0.0001);
+    }
+
+    TEST(Silence)
+    {
+        Aquila::SpectrumType spectrum(17, 0.0);
+        Aquila::PeakPicker picker(spectrum.size(), 0, spectrum.size(), 2);
+        CHECK_EQUAL(0u, picker.pick(&spectrum[0]));
+        CHECK_CLOSE(0.0, picker.getTotalPower(), 0.0001);
+    }
+
+    double interpolatedPosition(Aquila::PeakPicker::InterpolationType type,
+                                bool hamming)
+    {
+        // 256-sample frame, sine exactly between bins 20 and 21
+        const std::size_t FRAME = 256;
+        const double binPosition = 20.3;
+        Aquila::SampleType frame[FRAME];
+        for (std::size_t n = 0; n < FRAME; ++n)
+        {
+            double w = hamming ? 0.54 - 0.46 * std::cos(2.0 * M_PI * n / (FRAME - 1)) : 1.0;
+            frame[n] = w * std::sin(2.0 * M_PI * binPosition * n / FRAME);
+        }
+
+        Aquila::OouraFft fft(FRAME);
+        auto spectrum = fft.rfft(frame);
+        Aquila::PeakPicker picker(spectrum.size(), 1, FRAME / 2, 1, type);
+        picker.pick(&spectrum[0]);
+        CHECK_EQUAL(20u, picker.getPeak(0).bin);
+        return picker.getPeak(0).position;
+    }
+
+    TEST(NoInterpolation)
+    {
+        CHECK_CLOSE(20.0, interpolatedPosition(Aquila::PeakPicker::None, true), 0.00001);
+    }
+
+    TEST(ParabolicInterpolation)
+    {
+        CHECK_CLOSE(20.3, interpolatedPosition(Aquila::PeakPicker::Parabolic, true), 0.1);
+    }
+
+    TEST(GaussianInterpolation)
+    {
+        CHECK_CLOSE(20.3, interpolatedPosition(Aquila::PeakPicker::Gaussian, true), 0.02);
+    }
+
+    TEST(ComplexInterpolation)
+    {
+        CHECK_CLOSE(20.3, interpolatedPosition(Aquila::PeakPicker::Complex, false), 0.01);
+    }
+}
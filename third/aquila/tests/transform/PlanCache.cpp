@@ -0,0 +1,95 @@
+#include "aquila/global.h"
+#include "aquila/transform/PlanCache.h"
+#include "aquila/transform/OouraFft.h"
+#include "aquila/transform/SimdFft.h"
+#include "UnitTest++/UnitTest++.h"
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<int> builtPlans(0);
+
+    struct CountingPlan
+    {
+        CountingPlan(std::size_t length): length(length)
+        {
+            ++builtPlans;
+        }
+
+        std::size_t length;
+    };
+
+    /**
+     * Transforms the same signal on several threads at once, each with its
+     * own object (and thus the shared tables), and checks all agree.
+     */
+    template <typename FftType>
+    void concurrentTest(std::size_t size)
+    {
+        std::vector<Aquila::SampleType> signal(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            signal[i] = std::sin(0.2 * i) + 0.3 * std::cos(0.9 * i);
+        }
+        FftType reference(size);
+        Aquila::SpectrumType expected = reference.rfft(&signal[0]);
+
+        const std::size_t threadCount = 4;
+        std::vector<Aquila::SpectrumType> results(threadCount);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            threads.push_back(std::thread([&, t] {
+                FftType fft(size);
+                for (int i = 0; i < 50; ++i)
+                {
+                    results[t] = fft.rfft(&signal[0]);
+                }
+            }));
+        }
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            threads[t].join();
+        }
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            for (std::size_t k = 0; k <= size / 2; ++k)
+            {
+                CHECK_EQUAL(expected[k], results[t][k]);
+            }
+        }
+    }
+}
+
+
+SUITE(PlanCache)
+{
+    TEST(BuiltOncePerLength)
+    {
+        std::shared_ptr<const CountingPlan> a = Aquila::PlanCache<CountingPlan>::get(64);
+        std::shared_ptr<const CountingPlan> b = Aquila::PlanCache<CountingPlan>::get(64);
+        CHECK(a == b);
+        CHECK_EQUAL(1, builtPlans.load());
+        std::shared_ptr<const CountingPlan> c = Aquila::PlanCache<CountingPlan>::get(128);
+        CHECK(a != c);
+        CHECK_EQUAL(128u, c->length);
+        CHECK_EQUAL(2, builtPlans.load());
+    }
+
+    TEST(OouraSharedAcrossThreads)
+    {
+        concurrentTest<Aquila::OouraFft>(512);
+        // first use of a length from several threads at once
+        concurrentTest<Aquila::OouraFft>(2048);
+    }
+
+    TEST(SimdSharedAcrossThreads)
+    {
+        concurrentTest<Aquila::SimdFft>(512);
+        concurrentTest<Aquila::SimdFft>(8192);
+    }
+}
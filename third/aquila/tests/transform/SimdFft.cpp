@@ -0,0 +1,175 @@
+#include "Fft.h"
+#include "aquila/global.h"
+#include "aquila/Exceptions.h"
+#include "aquila/transform/SimdFft.h"
+#include "aquila/transform/OouraFft.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Test that every transform of a given kernel agrees with OouraFft.
+ */
+void matchesOouraTest(std::size_t size, Aquila::SimdFft::InstructionSet instructionSet)
+{
+#ifdef AQUILA_SINGLE_PRECISION
+    const double tolerance = size * 0.00001;
+#else
+    const double tolerance = size * 0.0000001;
+#endif
+    std::vector<Aquila::SampleType> testArray(size);
+    Aquila::SpectrumType data(size), reference(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        testArray[i] = std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i) + 0.1 * (i % 7);
+        data[i] = reference[i] = Aquila::ComplexType(testArray[i], std::cos(0.11 * i));
+    }
+
+    Aquila::SimdFft fft(size, instructionSet);
+    Aquila::OouraFft ooura(size);
+
+    Aquila::SpectrumType expected = ooura.rfft(&testArray[0]);
+    Aquila::SpectrumType actual = fft.rfft(&testArray[0]);
+    for (std::size_t k = 0; k <= size / 2; ++k)
+    {
+        CHECK_CLOSE(expected[k].real(), actual[k].real(), tolerance);
+        CHECK_CLOSE(expected[k].imag(), actual[k].imag(), tolerance);
+    }
+
+    ooura.fftInPlace(&reference[0]);
+    fft.fftInPlace(&data[0]);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        CHECK_CLOSE(reference[k].real(), data[k].real(), tolerance);
+        CHECK_CLOSE(reference[k].imag(), data[k].imag(), tolerance);
+    }
+
+    std::vector<Aquila::SampleType> restored(size);
+    fft.irfft(&actual[0], &restored[0]);
+    CHECK_ARRAY_CLOSE(testArray, restored, size, tolerance);
+}
+
+
+SUITE(SimdFft)
+{
+    TEST(Delta)
+    {
+        deltaSpectrumTest<Aquila::SimdFft, 8>();
+        deltaSpectrumTest<Aquila::SimdFft, 16>();
+        deltaSpectrumTest<Aquila::SimdFft, 128>();
+        deltaSpectrumTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(ConstSignal)
+    {
+        constSpectrumTest<Aquila::SimdFft, 8>();
+        constSpectrumTest<Aquila::SimdFft, 16>();
+        constSpectrumTest<Aquila::SimdFft, 128>();
+        constSpectrumTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(DeltaInverse)
+    {
+        deltaInverseTest<Aquila::SimdFft, 8>();
+        deltaInverseTest<Aquila::SimdFft, 16>();
+        deltaInverseTest<Aquila::SimdFft, 128>();
+        deltaInverseTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(ConstInverse)
+    {
+        constInverseTest<Aquila::SimdFft, 8>();
+        constInverseTest<Aquila::SimdFft, 16>();
+        constInverseTest<Aquila::SimdFft, 128>();
+        constInverseTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(Identity)
+    {
+        identityTest<Aquila::SimdFft, 8>();
+        identityTest<Aquila::SimdFft, 16>();
+        identityTest<Aquila::SimdFft, 128>();
+        identityTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(RealSpectrum)
+    {
+        realSpectrumTest<Aquila::SimdFft, 8>();
+        realSpectrumTest<Aquila::SimdFft, 16>();
+        realSpectrumTest<Aquila::SimdFft, 128>();
+        realSpectrumTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(RealIdentity)
+    {
+        realIdentityTest<Aquila::SimdFft, 8>();
+        realIdentityTest<Aquila::SimdFft, 16>();
+        realIdentityTest<Aquila::SimdFft, 128>();
+        realIdentityTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(InPlace)
+    {
+        inPlaceTest<Aquila::SimdFft, 8>();
+        inPlaceTest<Aquila::SimdFft, 16>();
+        inPlaceTest<Aquila::SimdFft, 128>();
+        inPlaceTest<Aquila::SimdFft, 1024>();
+    }
+
+    TEST(AllKernelsMatchOoura)
+    {
+        const Aquila::SimdFft::InstructionSet sets[] = {
+            Aquila::SimdFft::Scalar, Aquila::SimdFft::Sse2, Aquila::SimdFft::Avx2
+        };
+        for (std::size_t s = 0; s < 3; ++s)
+        {
+            for (std::size_t size = 4; size <= 4096; size *= 2)
+            {
+                matchesOouraTest(size, sets[s]);
+            }
+        }
+    }
+
+    TEST(BatchMatchesSingleTransforms)
+    {
+        const Aquila::SimdFft::InstructionSet sets[] = {
+            Aquila::SimdFft::Scalar, Aquila::SimdFft::Sse2, Aquila::SimdFft::Avx2
+        };
+        const std::size_t counts[] = {1, 7, 8, 19};
+        for (std::size_t s = 0; s < 3; ++s)
+        {
+            for (std::size_t size = 4; size <= 4096; size *= 2)
+            {
+                Aquila::SimdFft fft(size, sets[s]);
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    rfftBatchTest(fft, size, counts[c]);
+                }
+            }
+        }
+    }
+
+    TEST(Windowed)
+    {
+        for (std::size_t size = 4; size <= 4096; size *= 4)
+        {
+            Aquila::SimdFft fft(size);
+            rfftWindowedTest(fft, size);
+        }
+    }
+
+    TEST(KernelNeverExceedsProcessor)
+    {
+        Aquila::SimdFft fft(64, Aquila::SimdFft::Avx2);
+        CHECK(fft.getInstructionSet() <= Aquila::SimdFft::detectInstructionSet());
+        Aquila::SimdFft scalar(64, Aquila::SimdFft::Scalar);
+        CHECK_EQUAL(Aquila::SimdFft::Scalar, scalar.getInstructionSet());
+    }
+
+    TEST(WrongLength)
+    {
+        CHECK_THROW(Aquila::SimdFft fft(100), Aquila::ConfigurationException);
+        CHECK_THROW(Aquila::SimdFft fft(2), Aquila::ConfigurationException);
+    }
+}
@@ -4,6 +4,12 @@
 #include "aquila/transform/Spectrogram.h"
 #include "UnitTest++/UnitTest++.h"
 
+#ifdef AQUILA_SINGLE_PRECISION
+const double SPECTRUM_TOLERANCE = 0.0001;
+#else
+const double SPECTRUM_TOLERANCE = 0.00001;
+#endif
+
 void testSpectrumPeaks(std::size_t SIZE,
                        Aquila::FrequencyType sampleFrequency,
                        Aquila::FrequencyType testFrequency)
@@ -30,7 +36,7 @@ void testSpectrumPeaks(std::size_t SIZE,
         {
             absSpectrum[y] = std::abs(spectrogram.getPoint(x, y));
         }
-        CHECK_ARRAY_CLOSE(expected, absSpectrum, halfLength, 0.00001);
+        CHECK_ARRAY_CLOSE(expected, absSpectrum, halfLength, SPECTRUM_TOLERANCE);
     }
 }
 
@@ -0,0 +1,124 @@
+#include "aquila/global.h"
+#include "aquila/functions.h"
+#include "aquila/Exceptions.h"
+#include "aquila/source/generator/SineGenerator.h"
+#include "aquila/source/FramesCollection.h"
+#include "aquila/transform/Spectrogram.h"
+#include "aquila/transform/StreamingSpectrogram.h"
+#include "UnitTest++/UnitTest++.h"
+#include <cmath>
+#include <cstddef>
+
+
+SUITE(StreamingSpectrogram)
+{
+    const std::size_t N = 128;
+    Aquila::FrequencyType sampleFrequency = 8000;
+
+    TEST(Empty)
+    {
+        Aquila::StreamingSpectrogram<> spectrogram(N, 10);
+        CHECK_EQUAL(N, spectrogram.getSpectrumSize());
+        CHECK_EQUAL(N / 2 + 1, spectrogram.getBinCount());
+        CHECK_EQUAL(10u, spectrogram.getCapacity());
+        CHECK_EQUAL(0u, spectrogram.getFrameCount());
+        CHECK_EQUAL(0u, spectrogram.getTotalFrameCount());
+    }
+
+    TEST(KeepsLatestFrames)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(440).setAmplitude(1).generate(N * 25);
+        Aquila::FramesCollection frames(generator, N, N / 2);
+        Aquila::Spectrogram reference(frames);
+
+        Aquila::StreamingSpectrogram<> spectrogram(N, 10);
+        spectrogram.push(frames);
+        CHECK_EQUAL(10u, spectrogram.getFrameCount());
+        CHECK_EQUAL(frames.count(), spectrogram.getTotalFrameCount());
+        CHECK_EQUAL(frames.count() - 10, spectrogram.getFirstFrame());
+        for (std::size_t x = 0; x < spectrogram.getFrameCount(); ++x)
+        {
+            for (std::size_t k = 0; k < spectrogram.getBinCount(); ++k)
+            {
+                Aquila::ComplexType expected = reference.getPoint(spectrogram.getFirstFrame() + x, k);
+                CHECK_CLOSE(expected.real(), spectrogram.getPoint(x, k).real(), 0.0001);
+                CHECK_CLOSE(expected.imag(), spectrogram.getPoint(x, k).imag(), 0.0001);
+            }
+        }
+    }
+
+    TEST(PushOneByOne)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(1000).setAmplitude(1).generate(N * 5);
+        Aquila::FramesCollection frames(generator, N);
+        Aquila::Spectrogram reference(frames);
+
+        Aquila::StreamingSpectrogram<> spectrogram(N, 3);
+        for (auto it = frames.begin(); it != frames.end(); ++it)
+        {
+            spectrogram.push(it->toArray());
+        }
+        CHECK_EQUAL(3u, spectrogram.getFrameCount());
+        CHECK_EQUAL(2u, spectrogram.getFirstFrame());
+        CHECK_CLOSE(std::abs(reference.getPoint(4, 16)), std::abs(spectrogram.getPoint(2, 16)), 0.0001);
+
+        spectrogram.clear();
+        CHECK_EQUAL(0u, spectrogram.getFrameCount());
+        CHECK_EQUAL(0u, spectrogram.getTotalFrameCount());
+    }
+
+    TEST(Magnitudes)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(1000).setAmplitude(1).generate(N * 4);
+        Aquila::FramesCollection frames(generator, N);
+        Aquila::Spectrogram reference(frames);
+
+        Aquila::StreamingSpectrogram<Aquila::MagnitudeStorage> spectrogram(N, 4);
+        spectrogram.push(frames);
+        for (std::size_t k = 0; k < spectrogram.getBinCount(); ++k)
+        {
+            CHECK_CLOSE(std::abs(reference.getPoint(1, k)), spectrogram.getPoint(1, k), 0.0001);
+        }
+    }
+
+    TEST(QuantizedDecibels)
+    {
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(1000).setAmplitude(1).generate(N * 4);
+        Aquila::FramesCollection frames(generator, N);
+        Aquila::Spectrogram reference(frames);
+
+        Aquila::Decibel8Storage storage8(-60.0, 60.0);
+        Aquila::StreamingSpectrogram<Aquila::Decibel8Storage> spectrogram8(N, 4, storage8);
+        spectrogram8.push(frames);
+        Aquila::Decibel16Storage storage16(-60.0, 60.0);
+        Aquila::StreamingSpectrogram<Aquila::Decibel16Storage> spectrogram16(N, 4, storage16);
+        spectrogram16.push(frames);
+
+        for (std::size_t k = 0; k < spectrogram8.getBinCount(); ++k)
+        {
+            double expected = Aquila::clamp(-60.0, Aquila::dB(reference.getPoint(2, k)), 60.0);
+            CHECK_CLOSE(expected, spectrogram8.getPoint(2, k), storage8.getStep() / 2 + 0.0001);
+            CHECK_CLOSE(expected, spectrogram16.getPoint(2, k), storage16.getStep() / 2 + 0.0001);
+        }
+        // the sine peak, 20 log10(N / 2)
+        CHECK_CLOSE(20 * std::log10(N / 2.0), spectrogram16.getPoint(2, 16), 0.01);
+    }
+
+    TEST(WrongConfiguration)
+    {
+        CHECK_THROW(Aquila::StreamingSpectrogram<> spectrogram(N, 0),
+                    Aquila::ConfigurationException);
+        CHECK_THROW(Aquila::Decibel8Storage storage(0.0, 0.0),
+                    Aquila::ConfigurationException);
+
+        Aquila::SineGenerator generator(sampleFrequency);
+        generator.setFrequency(1000).setAmplitude(1).generate(N * 4);
+        Aquila::FramesCollection frames(generator, N / 2);
+        Aquila::StreamingSpectrogram<> spectrogram(N, 4);
+        CHECK_THROW(spectrogram.push(frames), Aquila::ConfigurationException);
+    }
+}